@@ -3,6 +3,7 @@
 #include <fstream> 
 #include <TFile.h>
 #include <TTree.h>
+#include <TChain.h>
 #include <TVector3.h>
 #include <TH1F.h>
 #include <TH2F.h>
@@ -14,25 +15,40 @@
 #include "set_vars_taggerbdt.h"
 #include "common_funtions.h"
 #include "set_vars_eval.h"
+#include "selection_variants.h"
+#include "branch_manifest.h"
+#include "input_files.h"
+#include "event_alignment.h"
+#include "histogram_registry.h"
+#include "event_summary.h"
+#include "cut_flow.h"
+#include "radius_scan.h"
+#include "bdt_scan.h"
+#include "event_range.h"
+#include "io_report.h"
+#include "read_cache.h"
+#include "stage_cache.h"
+#include "hist_bundle.h"
+#include "shard_merge.h"
+#include "skim.h"
+#include "rdf_engine.h"
 
 
 #include <string>
+#include <sstream>
+#include <algorithm>
+#include <memory>
 #include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
 #include "TSystem.h"
+#include "TKey.h"
+#include "TParameter.h"
 
 
 //using namespace std;
 
 
-// Helper function to extract file name without path or extension
-std::string GetBaseName(const std::string& filepath) {
-    size_t slash = filepath.find_last_of("/\\");
-    std::string filename = (slash == std::string::npos) ? filepath : filepath.substr(slash + 1);
-
-    size_t dot = filename.find_last_of(".");
-    return (dot == std::string::npos) ? filename : filename.substr(0, dot);
-}
-
 bool ParseBool(const std::string& s) {
     if (s == "1" || s == "true" || s == "True" || s == "TRUE")
         return true;
@@ -45,963 +61,1099 @@ bool ParseBool(const std::string& s) {
 }
 
 
-int main(int argc, char** argv) {
+// Histograms, counters and output file of one selection variant.
+// All variants are filled from the same event read in main(); each one is
+// written to <OutDir>/<input>_<label>[_Data][_BacktrkBlips].root as before.
+class SelectionPass {
+public:
 
-    if (argc < 6) {
-        std::cerr << "Usage:\n"
-                  << argv[0] 
-                  << " <inputFile.root> <label> <bool1> <bool2> <outputDir>\n";
-        std::cerr << "Example:\n"
-                  << argv[0] 
-                  << " data.root MyTag 1 0 Results\n";
-        return 1;
-    }
+    SelectionVariant variant;
 
-    std::string inputFile = argv[1];
-    std::string label     = argv[2];
-    bool IsData           = ParseBool(argv[3]);
-    bool AddBacktrackedBlips = ParseBool(argv[4]);
-    std::string outDir    = argv[5];
+    // Output file is opened first so the histograms below are created in it
+    TFile* fOutFile;
 
-    // Create output directory if missing
-    if (gSystem->AccessPathName(outDir.c_str())) {
-        std::cout << "Directory does not exist. Creating: " << outDir << std::endl;
-        gSystem->mkdir(outDir.c_str(), true);
-    } else {
-        std::cout << "Directory exists: " << outDir << std::endl;
-    }
+    float Radius = 75;
+    BlipGeometry fBlipGeometry;   // blip loop scratch, reused from event to event
 
-    // Base filename (input file name without extension)
-    std::string baseName  = GetBaseName(inputFile);
+    int WC_0p_wBB = 0,  WC_Np_wBB = 0; 
+    int signal_events = 0;
+    int NoSigNorBkg[kNSplits] = {};   // events in no truth category, by split (all, 0n, Nn)
+
+    CutFlow cutflow;                  // --cutflow (cut_flow.h)
+    RadiusScan radiusScan;            // --radius-scan (radius_scan.h)
+    BDTScanTable bdtScan;             // --bdt-scan (bdt_scan.h)
+    std::string config;               // selection_config of the output file (shard_merge.h)
+
+    SelectionPass(const SelectionVariant& v, const std::string& outputFile)
+        : variant(v), fOutFile(new TFile(outputFile.c_str(), "RECREATE")) {
+        fOutFile->cd();
+        hists.Book();
+        if (gCutFlow.enabled) cutflow.Book();
+        if (!gRadiusScan.radii.empty()) radiusScan.Book(fOutFile);
+        if (gBDTScan.enabled) bdtScan.Book();
+    }
 
-    // Start forming output filename
-    std::string outputName = baseName + "_" + label;
 
-    // Append flags if true (customize text below if desired)
-    if (IsData) outputName += "_Data";
-    if (AddBacktrackedBlips) outputName += "_BacktrkBlips";
+    // --- Histograms (histogram_registry.h), created in fOutFile ---
+    HistogramRegistry hists;
 
-    // Add ROOT extension and path
-    std::string outputFile = outDir + "/" + outputName + ".root";
 
-    std::cout << " ---- SETTINGS ----\n";
-    std::cout << " Input ROOT File : " << inputFile << "\n";
-    std::cout << " Signal/Sideband : " << label << "\n";
-    std::cout << " IsData          : " << (IsData ? "true" : "false") << "\n";
-    std::cout << " AddBackTrkBlips : " << (AddBacktrackedBlips ? "true" : "false") << "\n";
-    std::cout << " Output File     : " << outputFile << "\n";
-    std::cout << " ------------------\n";
+    // Fill everything for an event that passed this variant's preselection
+    // (event: SummarizeEvent of the current entry, shared by all variants)
+    void FillEvent(const BlipBatch& blips, const TVector3& ShVtx, const TVector3& ShowerMomentum,
+                   const EventSummary& event) {
 
-    // Open input file
-    TFile* fInputFile = TFile::Open(inputFile.c_str());
-    if (!fInputFile || fInputFile->IsZombie()) {
-        std::cerr << "ERROR: Could not open input ROOT file!\n";
-        return 1;
-    }
+			                        signal_events++ ; 
 
-    // Create output ROOT file
-    TFile* fOutFile = new TFile(outputFile.c_str(), "RECREATE");
+                                    //-- Blip section --
+                                        
+                                     int backtracked_blip = 0 ;  
+                                     // --- Blip loop ---
+                                     // Distances, angles, sphere/cone and region A/B of all blips at once (blip_kernel.h)
+                                     ClassifyBlips(blips, ShVtx, ShowerMomentum, Radius, fBlipGeometry);
+                                     const BlipGeometry& geo = fBlipGeometry;
+                                     if (gCutFlow.enabled) cutflow.CountBlips(blips, geo, Radius);
+
+                                     for (size_t iBlip = 0; iBlip < blips.n ; ++iBlip) {
+
+                                        // Only sphere blips are histogrammed: 2&3 matched-planes (3D-blips), no blips
+                                        // touching tracks, no blips by dead wires in pl2, distance to closest track > 15 [cm],
+                                        // blip distance from ShVtx < Radius
+                                        int flags = geo.flags[iBlip];
+                                        if (!(flags & kBlipSphere)) continue;
+
+                                        double values[kNBlipVars];
+                                        values[kBlipEnergy]   = blips.energy[iBlip];
+                                        values[kBlipDist2vtx] = geo.dist2vtx[iBlip];
+                                        values[kBlipAngle]    = geo.angle[iBlip];
+                                        values[kBlipCosangle] = geo.cosangle[iBlip];
+
+                                        // Every population the blip belongs to: sphere/signal, region A/B, MC/overlay, truth
+                                        for (int group = 0; group < kNBlipGroups; ++group) {
+                                            if ((flags & kBlipGroups[group].mask) != kBlipGroups[group].value) continue;
+                                            for (int var = 0; var < kNBlipVars; ++var) hists.Fill(BlipHist(group, var), values[var]);
+                                        }
 
+                                    } //<-- End Blip Loop 
 
+                                    // Blip counts, N protons and splits of this variant (event_summary.h)
+                                    EventSummary summary = event;
+                                    SummarizeBlips(blips, geo, variant.AddBacktrackedBlips, summary);
+                                    int N_rec_protons = summary.N_rec_protons;
 
+                                    if (!gRadiusScan.radii.empty())
+                                        radiusScan.Fill(blips, ShVtx, ShowerMomentum, event, variant.AddBacktrackedBlips);
 
 
+                                    //Inclusive Single Photon channels
+                                    int blipSplit = (summary.splitBits & kIs0n) ? kSplit0n : kSplitNn;
+                                    for (int split : {(int)kSplitAll, blipSplit}) {
+                                        hists.Fill(NprotonsHist(split), N_rec_protons);
+                                        // breakdown categories for single photon analysis
+                                        if (summary.category != kNoSPCategory) hists.Fill(SPHist(summary.category, split), N_rec_protons);
+                                        else NoSigNorBkg[split]++;
+                                    }
 
 
 
 
-    // --- Get TTree ---
-    TTree* fTree = (TTree*)fInputFile->Get("nuselection/NeutrinoSelectionFilter"); // PeLEE TTree
-    TTree *T_PFeval   = (TTree*)fInputFile->Get("wcpselection/T_PFeval");
-    TTree *T_BDTvars  = (TTree*)fInputFile->Get("wcpselection/T_BDTvars");
-    TTree *T_eval     = (TTree*)fInputFile->Get("wcpselection/T_eval");
-    TTree *T_pot      = (TTree*)fInputFile->Get("wcpselection/T_pot");
-    TTree *T_KINEvars = (TTree*)fInputFile->Get("wcpselection/T_KINEvars");
+                                    //----------------------
+                                    // --- 0p/Np split ---
+                                    //----------------------
+                                    int protonSplit = (summary.splitBits & kIs0p) ? kSplit0p : kSplitNp;
+                                    for (int split : {(int)kSplitAll, protonSplit}) {
+                                        hists.Fill(BlipMultiplicityHist(split), summary.n_sig_all_blips());
+                                        hists.Fill(SumEblipHist(split), summary.SumE_sig_all_blips());
+                                        hists.Hist2D(MultiplicitySumEHist(split))->Fill(summary.n_sig_all_blips(), summary.SumE_sig_all_blips());
+                                    }
 
 
-    if (!T_PFeval || !T_eval || !T_BDTvars || !T_KINEvars || !T_pot) {
-	    std::cerr << "Error: one or more trees not found!" << std::endl;
-        fInputFile->Close();
-        return 1;
+                                        if( summary.WC_N_rec_protons == 0 && backtracked_blip > 0 )WC_0p_wBB++ ; 
+                                        if( summary.WC_N_rec_protons > 0 && backtracked_blip > 0 )WC_Np_wBB++ ; 
+	                                    backtracked_blip = 0 ; 
     }
 
-    if (!fTree) {
-        std::cerr << "Error: cannot find tree 'nuselection/NeutrinoSelectionFilter'" << std::endl;
-        fInputFile->Close();
-        return 1;
+
+    // Event counters, by name, for shard merging
+    std::vector<std::pair<const char*, int*>> Counters() {
+        return { {"signal_events", &signal_events},
+                 {"NoSigNorBkg",   &NoSigNorBkg[kSplitAll]},
+                 {"NoSigNorBkg0n", &NoSigNorBkg[kSplit0n]},
+                 {"NoSigNorBkgNn", &NoSigNorBkg[kSplitNn]},
+                 {"WC_0p_wBB",     &WC_0p_wBB},
+                 {"WC_Np_wBB",     &WC_Np_wBB} };
     }
 
 
-    // Set the branches you plan on using; this function is in the "set_vars.h"
-    // file sourced at the top, along with all the variables.
-    setBranches(fTree); // blip info
-    setBranchesPFEval(T_PFeval);
-    setBranchesKINE(T_KINEvars);
-    setBranchesBDT(T_BDTvars);
-    setBranchesEval(T_eval);
+    // Writes this worker's histograms and counters into dir of a shard file
+    void WriteShard(TDirectory* dir) {
+        dir->cd();
+        WriteShardHists(fOutFile, dir);
+        if (gBDTScan.enabled) bdtScan.WriteShard(dir);
+        for (auto& counter : Counters()) {
+            TParameter<Long64_t> value(counter.first, *counter.second);
+            dir->WriteTObject(&value);
+        }
+    }
+
 
+    // Histograms of from and its subdirectories (--radius-scan), into to
+    static void WriteShardHists(TDirectory* from, TDirectory* to) {
+        TIter next(from->GetList());
+        while (TObject* obj = next()) {
+            if (obj->InheritsFrom("TDirectory")) WriteShardHists((TDirectory*)obj, to->mkdir(obj->GetName()));
+            else if (obj->InheritsFrom("TH1")) to->WriteTObject(obj);
+        }
+    }
 
 
+    // Adds the histograms and counters of a worker shard to this pass
+    // (target: the matching directory of the output file)
+    bool MergeShard(TDirectory* dir, TDirectory* target = nullptr) {
+        if (!dir) return false;
+        if (!target) target = fOutFile;
+        TIter next(dir->GetListOfKeys());
+        while (TKey* key = (TKey*)next()) {
+            if (std::string(key->GetClassName()) == "TDirectoryFile") {
+                TDirectory* sub = target->GetDirectory(key->GetName());
+                if (!sub) {
+                    std::cerr << "ERROR: shard directory " << key->GetName() << " has no match\n";
+                    return false;
+                }
+                if (!MergeShard(dir->GetDirectory(key->GetName()), sub)) return false;
+                continue;
+            }
+            TObject* obj = key->ReadObj();
+            if (std::string(obj->GetName()) == BDTScanTable::kCellTree) {
+                bdtScan.MergeShard((TTree*)obj);
+            } else if (obj->InheritsFrom("TH1")) {
+                TH1* hist = (TH1*)target->FindObject(obj->GetName());
+                if (!hist) {
+                    std::cerr << "ERROR: shard histogram " << obj->GetName() << " has no match\n";
+                    return false;
+                }
+                hist->Add((TH1*)obj);
+            } else {
+                for (auto& counter : Counters())
+                    if (std::string(counter.first) == obj->GetName())
+                        *counter.second += ((TParameter<Long64_t>*)obj)->GetVal();
+            }
+            delete obj;
+        }
+        return true;
+    }
 
 
-    
+    void Finish(int nevents) {
 
-    // --- Define histograms ---
+   fOutFile->cd();
 
-   TH1F *h_1gX_Nprotons = new TH1F("h_1gX_Nprotons", "Inclusive single shower selection; Number of Protons; Events", 10, 0, 10);
-   TH1F *h_1gX_Nprotons_0n = new TH1F("h_1gX_Nprotons_0n", "Inclusive single shower selection - 0n; Number of Protons; Events", 10, 0, 10);
-   TH1F *h_1gX_Nprotons_Nn = new TH1F("h_1gX_Nprotons_Nn", "Inclusive single shower selection - Nn; Number of Protons; Events", 10, 0, 10);
+   Float_t a;
+   TTree tree("evd_tree", "TTree with a single float branch for number of signal events");
+   TBranch* branch = tree.Branch("total_signal_events", &a, "total_signal_events/F");
+   a = signal_events ; 
+   tree.Fill();
 
-    //Signal events histograms
-    TH1F *h_SPNCDeltaSig_Nprotons = new TH1F("h_SPNCDeltaSig_Nprotons", "Inclusive 1g signal events;Number of Protons; Event counts", 10, 0, 10);
-    TH1F *h_SPNCPi0Sig_Nprotons = new TH1F("h_SPNCPi0Sig_Nprotons", "Inclusive 1g signal events;Number of Protons; Event counts", 10, 0, 10);
-    TH1F *h_SPNCOtherSig_Nprotons = new TH1F("h_SPNCOtherSig_Nprotons", "Inclusive 1g signal events;Number of Protons; Event counts", 10, 0, 10);
-    TH1F *h_SPNumuCCSig_Nprotons = new TH1F("h_SPNumuCCSig_Nprotons", "Inclusive 1g signal events;Number of Protons; Event counts", 10, 0, 10);
-    TH1F *h_SPOutFVSig_Nprotons = new TH1F("h_SPOutFVSig_Nprotons", "Inclusive 1g signal events;Number of Protons; Event counts", 10, 0, 10);
-    TH1F *h_SPNumuCCSigGen_Nprotons = new TH1F("h_SPNumuCCSigGen_Nprotons", "Inclusive 1g signal events;Number of Protons; Event counts", 10, 0, 10);
 
+    std::cout << "signal events/total events = "<< signal_events <<" / "<<nevents <<" = " << (float) signal_events / nevents<<std::endl; 
+    std::cout << "WC_0p_wBB: "<< WC_0p_wBB <<std::endl; 
+    std::cout << "WC_Np_wBB: "<< WC_Np_wBB <<std::endl;
+   
+/* 
+    std::cout <<"backtracked_blip_mc: "<< backtracked_blip_mc <<std::endl; 
+    std::cout <<"backtracked_blip_mc_proton: "<< backtracked_blip_mc_proton <<std::endl;
+    std::cout <<"backtracked_blip_mc_electron: "<< backtracked_blip_mc_electron <<std::endl;
+    std::cout <<"backtracked_blip_mc_heavyN: "<<backtracked_blip_mc_heavyN  <<std::endl;
+    std::cout <<"backtracked_blip_mc_othe: "<<backtracked_blip_mc_other  <<std::endl;
+    std::cout <<"backtracked_blip_overlay: "<< backtracked_blip_overlay  <<std::endl;
+*/
+    std::cout <<"\n"<<std::endl; 
+    std::cout<<" h_1gX_Nprotons :"<< hists[NprotonsHist(kSplitAll)]->GetEntries()<<std::endl; 
+    std::cout <<"Signal Categories\n"<<std::endl;
+    std::cout <<"h_SPNCDeltaSig_Nprotons :"<< hists[SPHist(kSPNCDeltaSig, kSplitAll)]->GetEntries()<<std::endl;
+    std::cout <<"h_SPNCPi0Sig_Nprotons   :"<< hists[SPHist(kSPNCPi0Sig, kSplitAll)]  ->GetEntries()<<std::endl; 
+    std::cout <<"h_SPNCOtherSig_Nprotons :"<< hists[SPHist(kSPNCOtherSig, kSplitAll)]->GetEntries()<<std::endl; 
+    std::cout <<"h_SPNumuCCSig_Nprotons  :"<< hists[SPHist(kSPNumuCCSig, kSplitAll)] ->GetEntries()<<std::endl;
+    std::cout <<"h_SPNumuCCSigGen_Nprotons  :"<< hists[SPHist(kSPNumuCCSigGen, kSplitAll)] ->GetEntries()<<std::endl;
+    std::cout <<"h_SPOutFVSig_Nprotons   :"<< hists[SPHist(kSPOutFVSig, kSplitAll)]  ->GetEntries()<<std::endl;
+    std::cout <<"Background Categories :"<<std::endl;
+    std::cout <<"h_SPoutFVBkg_Nprotons   :"<<hists[SPHist(kSPoutFVBkg, kSplitAll)]   ->GetEntries()<<std::endl;
+    std::cout <<"h_SPnumuCCBkg_Nprotons  :"<<hists[SPHist(kSPnumuCCBkg, kSplitAll)]  ->GetEntries()<<std::endl;
+    std::cout <<"h_SPnumuCCpi0Bkg_Nprotons:"<<hists[SPHist(kSPnumuCCpi0Bkg, kSplitAll)]->GetEntries()<<std::endl;
+    std::cout <<"h_SPnueCCBkg_Nprotons  :"<<hists[SPHist(kSPnueCCBkg, kSplitAll)]  ->GetEntries()<<std::endl;
+    std::cout <<"h_SPNCBkg_Nprotons       :"<<hists[SPHist(kSPNCBkg, kSplitAll)]     ->GetEntries()<<std::endl;
+    std::cout <<"h_SPNCpi0Bkg_Nprotons    :"<<hists[SPHist(kSPNCpi0Bkg, kSplitAll)] ->GetEntries()<<std::endl;
+    std::cout <<"h_CosmicBkg_Nprotons     :"<<hists[SPHist(kCosmicBkg, kSplitAll)] ->GetEntries()<<std::endl;
+    std::cout <<"No Signal nor Background:"<<NoSigNorBkg[kSplitAll]<<std::endl; 
+   
+    if (gCutFlow.enabled) {
+        std::string json = fOutFile->GetName();
+        if (json.size() > 5 && json.compare(json.size() - 5, 5, ".root") == 0) json.resize(json.size() - 5);
+        json += ".cutflow.json";
+        if (cutflow.WriteJSON(json, variant.label)) std::cout << "Cut flow written to " << json << std::endl;
+    }
 
-    //Background events histograms 
-    TH1F *h_SPoutFVBkg_Nprotons = new TH1F("h_SPoutFVBkg_Nprotons", "Inclusive 1g signal events;Number of Protons; Event counts", 10, 0, 10);
-    TH1F *h_SPnumuCCBkg_Nprotons = new TH1F("h_SPnumuCCBkg_Nprotons", "Inclusive 1g signal events;Number of Protons; Event counts", 10, 0, 10);
-    TH1F *h_SPnumuCCpi0Bkg_Nprotons = new TH1F("h_SPnumuCCpi0Bkg_Nprotons", "Inclusive 1g signal events;Number of Protons; Event counts", 10, 0, 10);
-    TH1F *h_SPnueCCBkg_Nprotons = new TH1F("h_SPnueCCBkg_Nprotons", "Inclusive 1g signal events;Number of Protons; Event counts", 10, 0, 10);
-    TH1F *h_SPNCBkg_Nprotons = new TH1F("h_SPNCBkg_Nprotons", "Inclusive 1g signal events;Number of Protons; Event counts", 10, 0, 10);
-    TH1F *h_SPNCpi0Bkg_Nprotons = new TH1F("h_SPNCpi0Bkg_Nprotons", "Inclusive 1g signal events;Number of Protons; Event counts", 10, 0, 10);
-    TH1F *h_CosmicBkg_Nprotons = new TH1F("h_CosmicBkg_Nprotons", "Inclusive 1g signal events;Number of Protons; Event counts", 10, 0, 10);
+    if (gBDTScan.enabled) bdtScan.Write(fOutFile);
+    WriteEventRange(fOutFile, gEventRange);
 
+    // Counters and configuration, for merge_shards
+    TDirectory* counters = fOutFile->mkdir(kCountersDir);
+    for (auto& counter : Counters()) {
+        TParameter<Long64_t> value(counter.first, *counter.second);
+        counters->WriteTObject(&value);
+    }
+    TNamed selectionConfig(kSelectionConfig, config.c_str());
+    fOutFile->WriteTObject(&selectionConfig);
 
-   //0n/Nn split
-    //Signal events histograms
-    TH1F *h_SPNCDeltaSig_Nprotons_0n = new TH1F("h_SPNCDeltaSig_Nprotons_0n", "Inclusive 1g signal events - 0n;Number of Protons; Event counts", 10, 0, 10);
-    TH1F *h_SPNCPi0Sig_Nprotons_0n = new TH1F("h_SPNCPi0Sig_Nprotons_0n", "Inclusive 1g signal events - 0n;Number of Protons; Event counts", 10, 0, 10);
-    TH1F *h_SPNCOtherSig_Nprotons_0n = new TH1F("h_SPNCOtherSig_Nprotons_0n", "Inclusive 1g signal events - 0n;Number of Protons; Event counts", 10, 0, 10);
-    TH1F *h_SPNumuCCSig_Nprotons_0n = new TH1F("h_SPNumuCCSig_Nprotons_0n", "Inclusive 1g signal events - 0n;Number of Protons; Event counts", 10, 0, 10);
-    TH1F *h_SPOutFVSig_Nprotons_0n = new TH1F("h_SPOutFVSig_Nprotons_0n", "Inclusive 1g signal events - 0n;Number of Protons; Event counts", 10, 0, 10);
-    TH1F *h_SPNumuCCSigGen_Nprotons_0n = new TH1F("h_SPNumuCCSigGen_Nprotons_0n", "Inclusive 1g signal events - 0n;Number of Protons; Event counts", 10, 0, 10);
+//     std::cout << "Histograms saved to " << outputFile << std::endl;
+    fOutFile->Write();
+    if (gWriteHistBundle) {
+        std::string bundle = BundleBaseName(fOutFile->GetName());
+        if (WriteHistBundle(bundle, fOutFile)) std::cout << "Histogram bundle written to " << bundle << std::endl;
+    }
+    fOutFile->Close();
+    }
+};
 
 
-    //Background events histograms
-    TH1F *h_SPoutFVBkg_Nprotons_0n = new TH1F("h_SPoutFVBkg_Nprotons_0n", "Inclusive 1g signal events - 0n;Number of Protons; Event counts", 10, 0, 10);
-    TH1F *h_SPnumuCCBkg_Nprotons_0n = new TH1F("h_SPnumuCCBkg_Nprotons_0n", "Inclusive 1g signal events - 0n;Number of Protons; Event counts", 10, 0, 10);
-    TH1F *h_SPnumuCCpi0Bkg_Nprotons_0n = new TH1F("h_SPnumuCCpi0Bkg_Nprotons_0n", "Inclusive 1g signal events - 0n;Number of Protons; Event counts", 10, 0, 10);
-    TH1F *h_SPnueCCBkg_Nprotons_0n = new TH1F("h_SPnueCCBkg_Nprotons_0n", "Inclusive 1g signal events - 0n;Number of Protons; Event counts", 10, 0, 10);
-    TH1F *h_SPNCBkg_Nprotons_0n = new TH1F("h_SPNCBkg_Nprotons_0n", "Inclusive 1g signal events - 0n;Number of Protons; Event counts", 10, 0, 10);
-    TH1F *h_SPNCpi0Bkg_Nprotons_0n = new TH1F("h_SPNCpi0Bkg_Nprotons_0n", "Inclusive 1g signal events - 0n;Number of Protons; Event counts", 10, 0, 10);
-    TH1F *h_CosmicBkg_Nprotons_0n = new TH1F("h_CosmicBkg_Nprotons_0n", "Inclusive 1g signal events - 0n;Number of Protons; Event counts", 10, 0, 10);
 
 
+// Input chains of the five trees read in the event loop, plus T_pot
+struct InputSet {
+    std::vector<std::string> files;
+    std::vector<TChain*> chains;
+    std::vector<InputTree> trees;
+    bool isSkim = false;   // input is a --skim output (skim.h)
+};
 
+void CloseInput(InputSet& input) {
+    for (TChain* chain : input.chains) delete chain;
+    input.chains.clear();
+    input.trees.clear();
+}
 
-//Nn
-    //Signal events histograms
-    TH1F *h_SPNCDeltaSig_Nprotons_Nn = new TH1F("h_SPNCDeltaSig_Nprotons_Nn", "Inclusive 1g signal events - Nn;Number of Protons; Event counts", 10, 0, 10);
-    TH1F *h_SPNCPi0Sig_Nprotons_Nn = new TH1F("h_SPNCPi0Sig_Nprotons_Nn", "Inclusive 1g signal events - Nn;Number of Protons; Event counts", 10, 0, 10);
-    TH1F *h_SPNCOtherSig_Nprotons_Nn = new TH1F("h_SPNCOtherSig_Nprotons_Nn", "Inclusive 1g signal events - Nn;Number of Protons; Event counts", 10, 0, 10);
-    TH1F *h_SPNumuCCSig_Nprotons_Nn = new TH1F("h_SPNumuCCSig_Nprotons_Nn", "Inclusive 1g signal events - Nn;Number of Protons; Event counts", 10, 0, 10);
-    TH1F *h_SPOutFVSig_Nprotons_Nn = new TH1F("h_SPOutFVSig_Nprotons_Nn", "Inclusive 1g signal events - Nn;Number of Protons; Event counts", 10, 0, 10);
-    TH1F *h_SPNumuCCSigGen_Nprotons_Nn = new TH1F("h_SPNumuCCSigGen_Nprotons_Nn", "Inclusive 1g signal events - Nn;Number of Protons; Event counts", 10, 0, 10);
-
-
-    //Background events histograms
-    TH1F *h_SPoutFVBkg_Nprotons_Nn = new TH1F("h_SPoutFVBkg_Nprotons_Nn", "Inclusive 1g signal events - Nn;Number of Protons; Event counts", 10, 0, 10);
-    TH1F *h_SPnumuCCBkg_Nprotons_Nn = new TH1F("h_SPnumuCCBkg_Nprotons_Nn", "Inclusive 1g signal events - Nn;Number of Protons; Event counts", 10, 0, 10);
-    TH1F *h_SPnumuCCpi0Bkg_Nprotons_Nn = new TH1F("h_SPnumuCCpi0Bkg_Nprotons_Nn", "Inclusive 1g signal events - Nn;Number of Protons; Event counts", 10, 0, 10);
-    TH1F *h_SPnueCCBkg_Nprotons_Nn = new TH1F("h_SPnueCCBkg_Nprotons_Nn", "Inclusive 1g signal events - Nn;Number of Protons; Event counts", 10, 0, 10);
-    TH1F *h_SPNCBkg_Nprotons_Nn = new TH1F("h_SPNCBkg_Nprotons_Nn", "Inclusive 1g signal events - Nn;Number of Protons; Event counts", 10, 0, 10);
-    TH1F *h_SPNCpi0Bkg_Nprotons_Nn = new TH1F("h_SPNCpi0Bkg_Nprotons_Nn", "Inclusive 1g signal events - Nn;Number of Protons; Event counts", 10, 0, 10);
-    TH1F *h_CosmicBkg_Nprotons_Nn = new TH1F("h_CosmicBkg_Nprotons_Nn", "Inclusive 1g signal events - Nn;Number of Protons; Event counts", 10, 0, 10);
-
-
-
-
-
-
-
-  //Signal true0p/Np split
-    TH1F *h_SPNCDeltaSig_Nprotons_0p = new TH1F("h_SPNCDeltaSig_Nprotons_0p", "Inclusive 1g signal events;Number of Protons; Event counts", 10, 0, 10);
-    TH1F *h_SPNCPi0Sig_Nprotons_0p = new TH1F("h_SPNCPi0Sig_Nprotons_0p", "Inclusive 1g signal events;Number of Protons; Event counts", 10, 0, 10);
-    TH1F *h_SPNCOtherSig_Nprotons_0p = new TH1F("h_SPNCOtherSig_Nprotons_0p", "Inclusive 1g signal events;Number of Protons; Event counts", 10, 0, 10);
-    TH1F *h_SPNumuCCSig_Nprotons_0p = new TH1F("h_SPNumuCCSig_Nprotons_0p", "Inclusive 1g signal events;Number of Protons; Event counts", 10, 0, 10);
-    TH1F *h_SPOutFVSig_Nprotons_0p = new TH1F("h_SPOutFVSig_Nprotons_0p", "Inclusive 1g signal events;Number of Protons; Event counts", 10, 0, 10);
-    TH1F *h_SPNumuCCSigGen_Nprotons_0p = new TH1F("h_SPNumuCCSigGen_Nprotons_0p", "Inclusive 1g signal events;Number of Protons; Event counts", 10, 0, 10);
-
-    TH1F *h_SPNCDeltaSig_Nprotons_Np = new TH1F("h_SPNCDeltaSig_Nprotons_Np", "Inclusive 1g signal events;Number of Protons; Event counts", 10, 0, 10);
-    TH1F *h_SPNCPi0Sig_Nprotons_Np = new TH1F("h_SPNCPi0Sig_Nprotons_Np", "Inclusive 1g signal events;Number of Protons; Event counts", 10, 0, 10);
-    TH1F *h_SPNCOtherSig_Nprotons_Np = new TH1F("h_SPNCOtherSig_Nprotons_Np", "Inclusive 1g signal events;Number of Protons; Event counts", 10, 0, 10);
-    TH1F *h_SPNumuCCSig_Nprotons_Np = new TH1F("h_SPNumuCCSig_Nprotons_Np", "Inclusive 1g signal events;Number of Protons; Event counts", 10, 0, 10);
-    TH1F *h_SPOutFVSig_Nprotons_Np = new TH1F("h_SPOutFVSig_Nprotons_Np", "Inclusive 1g signal events;Number of Protons; Event counts", 10, 0, 10);
-    TH1F *h_SPNumuCCSigGen_Nprotons_Np = new TH1F("h_SPNumuCCSigGen_Nprotons_Np", "Inclusive 1g signal events;Number of Protons; Event counts", 10, 0, 10);
-
-
-
-// -- 0p/Np ---
-TH1F *h_1gX_BlipMultiplicity = new TH1F("h_1gX_BlipMultiplicity", "Inclusive 1g signal events; Blip multiplicity ; counts", 100, 0, 100);
-TH1F* h_1gX_SumEblip         = new TH1F("h_1gX_SumEblip", "Inclusive 1g signal events; Summed blip energy [MeV_{ee}]; Counts", 100, 0, 100);
-//0p
-TH1F *h_1gX_BlipMultiplicity_0p = new TH1F("h_1gX_BlipMultiplicity_0p", "Inclusive 1g signal events; Blip multiplicity ; counts", 100, 0, 100);
-TH1F* h_1gX_SumEblip_0p         = new TH1F("h_1gX_SumEblip_0p", "Inclusive 1g signal events; Summed blip energy [MeV_{ee}]; Counts", 100, 0, 100);
-//Np
-TH1F *h_1gX_BlipMultiplicity_Np = new TH1F("h_1gX_BlipMultiplicity_Np", "Inclusive 1g signal events; Blip multiplicity ; counts", 100, 0, 100);
-TH1F* h_1gX_SumEblip_Np         = new TH1F("h_1gX_SumEblip_Np", "Inclusive 1g signal events; Summed blip energy [MeV_{ee}]; Counts", 100, 0, 100);
-
-//2D BlipMultiplicity vs SumEblip
-TH2F *h2D_1gX_BlipMultiplicity_SumEblip = new TH2F("h2D_1gX_BlipMultiplicity_SumEblip", "Inclusive 1g signal events; Blip multiplicity ; Sum E blip", 100, 0, 100,  100, 0, 100);
-TH2F *h2D_1gX_BlipMultiplicity_SumEblip_0p = new TH2F("h2D_1gX_BlipMultiplicity_SumEblip_0p", "Inclusive 1g signal events; Blip multiplicity ; Sum E blip", 100, 0, 100,  100, 0, 100);
-TH2F *h2D_1gX_BlipMultiplicity_SumEblip_Np = new TH2F("h2D_1gX_BlipMultiplicity_SumEblip_Np", "Inclusive 1g signal events; Blip multiplicity ; Sum E blip", 100, 0, 100,  100, 0, 100);
-
-
-
-
-// ---  All sphere --- 
-TH1F* h_Blip_sphere_all_energy    = new TH1F("h_Blip_sphere_all_energy",   "All sphere blips ; Blip energy [MeV_{ee}]; Counts", 100, 0, 50);
-TH1F* h_Blip_sphere_all_dist2vtx  = new TH1F("h_Blip_sphere_all_dist2vtx", "All sphere blips ; Blip distance to shower vertex [cm]; Counts", 160, 0, 800);
-TH1F* h_Blip_sphere_all_angle     = new TH1F("h_Blip_sphere_all_angle",    "All sphere blips ; #alpha [degrees]; Counts", 36, 0, 180);
-TH1F* h_Blip_sphere_all_cosangle  = new TH1F("h_Blip_sphere_all_cosangle", "All sphere blips ; Cos(#alpha); Counts", 800, -1, 1);
-// MC sphere 
-TH1F* h_Blip_sphere_all_energy_mc    = new TH1F("h_Blip_sphere_all_energy_mc",   "MC sphere blips ; Blip energy [MeV_{ee}]; Counts", 100, 0, 50);
-TH1F* h_Blip_sphere_all_dist2vtx_mc  = new TH1F("h_Blip_sphere_all_dist2vtx_mc", "MC sphere blips ; Blip distance to shower vertex [cm]; Counts", 160, 0, 800);
-TH1F* h_Blip_sphere_all_angle_mc     = new TH1F("h_Blip_sphere_all_angle_mc",    "MC sphere blips ; #alpha [degrees]; Counts", 36, 0, 180);
-TH1F* h_Blip_sphere_all_cosangle_mc  = new TH1F("h_Blip_sphere_all_cosangle_mc", "MC sphere blips ; Cos(#alpha); Counts", 800, -1, 1);
-// MC sphere protons
-TH1F* h_Blip_sphere_all_energy_mc_p    = new TH1F("h_Blip_sphere_all_energy_mc_p",   " MC-p sphere blips ; Blip energy [MeV_{ee}]; Counts", 100, 0, 50);
-TH1F* h_Blip_sphere_all_dist2vtx_mc_p  = new TH1F("h_Blip_sphere_all_dist2vtx_mc_p", " MC-p sphere blips ; Blip distance to shower vertex [cm]; Counts", 160, 0, 800);
-TH1F* h_Blip_sphere_all_angle_mc_p     = new TH1F("h_Blip_sphere_all_angle_mc_p",    " MC-p sphere blips ; #alpha [degrees]; Counts", 36, 0, 180);
-TH1F* h_Blip_sphere_all_cosangle_mc_p  = new TH1F("h_Blip_sphere_all_cosangle_mc_p", " MC-p sphere blips ; Cos(#alpha); Counts", 800, -1, 1);
-// MC sphere e+/e-
-TH1F* h_Blip_sphere_all_energy_mc_e    = new TH1F("h_Blip_sphere_all_energy_mc_e",   " MC-e sphere blips ; Blip energy [MeV_{ee}]; Counts", 100, 0, 50);
-TH1F* h_Blip_sphere_all_dist2vtx_mc_e  = new TH1F("h_Blip_sphere_all_dist2vtx_mc_e", " MC-e sphere blips ; Blip distance to shower vertex [cm]; Counts", 160, 0, 800);
-TH1F* h_Blip_sphere_all_angle_mc_e     = new TH1F("h_Blip_sphere_all_angle_mc_e",    " MC-e sphere blips ; #alpha [degrees]; Counts", 36, 0, 180);
-TH1F* h_Blip_sphere_all_cosangle_mc_e  = new TH1F("h_Blip_sphere_all_cosangle_mc_e", " MC-e sphere blips ; Cos(#alpha); Counts", 800, -1, 1);
-// MC sphere heavy nuclei
-TH1F* h_Blip_sphere_all_energy_mc_HN    = new TH1F("h_Blip_sphere_all_energy_mc_HN",   " MC-HN sphere blips ; Blip energy [MeV_{ee}]; Counts", 100, 0, 50);
-TH1F* h_Blip_sphere_all_dist2vtx_mc_HN  = new TH1F("h_Blip_sphere_all_dist2vtx_mc_HN", " MC-HN sphere blips ; Blip distance to shower vertex [cm]; Counts", 160, 0, 800);
-TH1F* h_Blip_sphere_all_angle_mc_HN     = new TH1F("h_Blip_sphere_all_angle_mc_HN",    " MC-HN sphere blips ; #alpha [degrees]; Counts", 36, 0, 180);
-TH1F* h_Blip_sphere_all_cosangle_mc_HN  = new TH1F("h_Blip_sphere_all_cosangle_mc_HN", " MC-HN sphere blips ; Cos(#alpha); Counts", 800, -1, 1);
-// MC sphere other
-TH1F* h_Blip_sphere_all_energy_mc_other    = new TH1F("h_Blip_sphere_all_energy_mc_other",   " MC-other sphere blips ; Blip energy [MeV_{ee}]; Counts", 100, 0, 50);
-TH1F* h_Blip_sphere_all_dist2vtx_mc_other  = new TH1F("h_Blip_sphere_all_dist2vtx_mc_other", " MC-other sphere blips ; Blip distance to shower vertex [cm]; Counts", 160, 0, 800);
-TH1F* h_Blip_sphere_all_angle_mc_other     = new TH1F("h_Blip_sphere_all_angle_mc_other",    " MC-other sphere blips ; #alpha [degrees]; Counts", 36, 0, 180);
-TH1F* h_Blip_sphere_all_cosangle_mc_other  = new TH1F("h_Blip_sphere_all_cosangle_mc_other", " MC-other sphere blips ; Cos(#alpha); Counts", 800, -1, 1);
-// Overlay sphere
-TH1F* h_Blip_sphere_all_energy_over    = new TH1F("h_Blip_sphere_all_energy_over",   "All sphere blips ; Blip energy [MeV_{ee}]; Counts", 100, 0, 50);
-TH1F* h_Blip_sphere_all_dist2vtx_over  = new TH1F("h_Blip_sphere_all_dist2vtx_over", "All sphere blips ; Blip distance to shower vertex [cm]; Counts", 160, 0, 800);
-TH1F* h_Blip_sphere_all_angle_over     = new TH1F("h_Blip_sphere_all_angle_over",    "All sphere blips ; #alpha [degrees]; Counts", 36, 0, 180);
-TH1F* h_Blip_sphere_all_cosangle_over  = new TH1F("h_Blip_sphere_all_cosangle_over", "All sphere blips ; Cos(#alpha); Counts", 800, -1, 1);
-
-
-
-// -- All Signal blips ---
-TH1F* h_Blip_signal_all_energy    = new TH1F("h_Blip_signal_all_energy",   "All signal blips ; Blip energy [MeV_{ee}]; Counts", 100, 0, 50);
-TH1F* h_Blip_signal_all_dist2vtx  = new TH1F("h_Blip_signal_all_dist2vtx", "All signal blips ; Blip distance to shower vertex [cm]; Counts", 160, 0, 800);
-TH1F* h_Blip_signal_all_angle     = new TH1F("h_Blip_signal_all_angle",    "All signal blips ; #alpha [degrees]; Counts", 36, 0, 180);
-TH1F* h_Blip_signal_all_cosangle  = new TH1F("h_Blip_signal_all_cosangle", "All signal blips ; Cos(#alpha); Counts", 800, -1, 1);
-// All Reg A Signal blips
-TH1F* h_Blip_signal_all_regA_energy    = new TH1F("h_Blip_signal_all_regA_energy",   "All regA signal blips ; Blip energy [MeV_{ee}]; Counts", 100, 0, 50);
-TH1F* h_Blip_signal_all_regA_dist2vtx  = new TH1F("h_Blip_signal_all_regA_dist2vtx", "All regA signal blips ; Blip distance to shower vertex [cm]; Counts", 160, 0, 800);
-TH1F* h_Blip_signal_all_regA_angle     = new TH1F("h_Blip_signal_all_regA_angle",    "All regA signal blips ; #alpha [degrees]; Counts", 36, 0, 180);
-TH1F* h_Blip_signal_all_regA_cosangle  = new TH1F("h_Blip_signal_all_regA_cosangle", "All regA signal blips ; Cos(#alpha); Counts", 800, -1, 1);
-// All Reg B Signal blips
-TH1F* h_Blip_signal_all_regB_energy    = new TH1F("h_Blip_signal_all_regB_energy",   "All regB signal blips ; Blip energy [MeV_{ee}]; Counts", 100, 0, 50);
-TH1F* h_Blip_signal_all_regB_dist2vtx  = new TH1F("h_Blip_signal_all_regB_dist2vtx", "All regB signal blips ; Blip distance to shower vertex [cm]; Counts", 160, 0, 800);
-TH1F* h_Blip_signal_all_regB_angle     = new TH1F("h_Blip_signal_all_regB_angle",    "All regB signal blips ; #alpha [degrees]; Counts", 36, 0, 180);
-TH1F* h_Blip_signal_all_regB_cosangle  = new TH1F("h_Blip_signal_all_regB_cosangle", "All regB signal blips ; Cos(#alpha); Counts", 800, -1, 1);
-
-
-// -- MC Signal blips ---
-TH1F* h_Blip_signal_mc_energy    = new TH1F("h_Blip_signal_mc_energy",   "MC signal blips ; Blip energy [MeV_{ee}]; Counts", 100, 0, 50);
-TH1F* h_Blip_signal_mc_dist2vtx  = new TH1F("h_Blip_signal_mc_dist2vtx", "MC signal blips ; Blip distance to shower vertex [cm]; Counts", 160, 0, 800);
-TH1F* h_Blip_signal_mc_angle     = new TH1F("h_Blip_signal_mc_angle",    "MC signal blips ; #alpha [degrees]; Counts", 36, 0, 180);
-TH1F* h_Blip_signal_mc_cosangle  = new TH1F("h_Blip_signal_mc_cosangle", "MC signal blips ; Cos(#alpha); Counts", 800, -1, 1);
-// MC signal p
-TH1F* h_Blip_signal_mc_energy_p    = new TH1F("h_Blip_signal_mc_energy_p",   "MC-p signal blips ; Blip energy [MeV_{ee}]; Counts", 100, 0, 50);
-TH1F* h_Blip_signal_mc_dist2vtx_p  = new TH1F("h_Blip_signal_mc_dist2vtx_p", "MC-p signal blips ; Blip distance to shower vertex [cm]; Counts", 160, 0, 800);
-TH1F* h_Blip_signal_mc_angle_p     = new TH1F("h_Blip_signal_mc_angle_p",    "MC-p signal blips ; #alpha [degrees]; Counts", 36, 0, 180);
-TH1F* h_Blip_signal_mc_cosangle_p  = new TH1F("h_Blip_signal_mc_cosangle_p", "MC-p signal blips ; Cos(#alpha); Counts", 800, -1, 1);
-// MC signal e+/e-
-TH1F* h_Blip_signal_mc_energy_e    = new TH1F("h_Blip_signal_mc_energy_e",   " MC-e signal blips ; Blip energy [MeV_{ee}]; Counts", 100, 0, 50);
-TH1F* h_Blip_signal_mc_dist2vtx_e  = new TH1F("h_Blip_signal_mc_dist2vtx_e", " MC-e signal blips ; Blip distance to shower vertex [cm]; Counts", 160, 0, 800);
-TH1F* h_Blip_signal_mc_angle_e     = new TH1F("h_Blip_signal_mc_angle_e",    " MC-e signal blips ; #alpha [degrees]; Counts", 36, 0, 180);
-TH1F* h_Blip_signal_mc_cosangle_e  = new TH1F("h_Blip_signal_mc_cosangle_e", " MC-e signal blips ; Cos(#alpha); Counts", 800, -1, 1);
-// MC signal heavy nuclei
-TH1F* h_Blip_signal_mc_energy_HN    = new TH1F("h_Blip_signal_mc_energy_HN",   " MC-HN signal blips ; Blip energy [MeV_{ee}]; Counts", 100, 0, 50);
-TH1F* h_Blip_signal_mc_dist2vtx_HN  = new TH1F("h_Blip_signal_mc_dist2vtx_HN", " MC-HN signal blips ; Blip distance to shower vertex [cm]; Counts", 160, 0, 800);
-TH1F* h_Blip_signal_mc_angle_HN     = new TH1F("h_Blip_signal_mc_angle_HN",    " MC-HN signal blips ; #alpha [degrees]; Counts", 36, 0, 180);
-TH1F* h_Blip_signal_mc_cosangle_HN  = new TH1F("h_Blip_signal_mc_cosangle_HN", " MC-HN signal blips ; Cos(#alpha); Counts", 800, -1, 1);
-// MC signal other
-TH1F* h_Blip_signal_mc_energy_other    = new TH1F("h_Blip_signal_mc_energy_other",   " MC-other signal blips ; Blip energy [MeV_{ee}]; Counts", 100, 0, 50);
-TH1F* h_Blip_signal_mc_dist2vtx_other  = new TH1F("h_Blip_signal_mc_dist2vtx_other", " MC-other signal blips ; Blip distance to shower vertex [cm]; Counts", 160, 0, 800);
-TH1F* h_Blip_signal_mc_angle_other     = new TH1F("h_Blip_signal_mc_angle_other",    " MC-other signal blips ; #alpha [degrees]; Counts", 36, 0, 180);
-TH1F* h_Blip_signal_mc_cosangle_other  = new TH1F("h_Blip_signal_mc_cosangle_other", " MC-other signal blips ; Cos(#alpha); Counts", 800, -1, 1);
-
-
-// -- MC Region A Signal blips ---
-TH1F* h_Blip_signal_mc_regA_energy    = new TH1F("h_Blip_signal_mc_regA_energy",   "MC regA signal blips ; Blip energy [MeV_{ee}]; Counts", 100, 0, 50);
-TH1F* h_Blip_signal_mc_regA_dist2vtx  = new TH1F("h_Blip_signal_mc_regA_dist2vtx", "MC regA signal blips ; Blip distance to shower vertex [cm]; Counts", 160, 0, 800);
-TH1F* h_Blip_signal_mc_regA_angle     = new TH1F("h_Blip_signal_mc_regA_angle",    "MC regA signal blips ; #alpha [degrees]; Counts", 36, 0, 180);
-TH1F* h_Blip_signal_mc_regA_cosangle  = new TH1F("h_Blip_signal_mc_regA_cosangle", "MC regA signal blips ; Cos(#alpha); Counts", 800, -1, 1);
-// MC regA signal p
-TH1F* h_Blip_signal_mc_regA_energy_p    = new TH1F("h_Blip_signal_mc_regA_energy_p",   "MC regA-p signal blips ; Blip energy [MeV_{ee}]; Counts", 100, 0, 50);
-TH1F* h_Blip_signal_mc_regA_dist2vtx_p  = new TH1F("h_Blip_signal_mc_regA_dist2vtx_p", "MC regA-p signal blips ; Blip distance to shower vertex [cm]; Counts", 160, 0, 800);
-TH1F* h_Blip_signal_mc_regA_angle_p     = new TH1F("h_Blip_signal_mc_regA_angle_p",    "MC regA-p signal blips ; #alpha [degrees]; Counts", 36, 0, 180);
-TH1F* h_Blip_signal_mc_regA_cosangle_p  = new TH1F("h_Blip_signal_mc_regA_cosangle_p", "MC regA-p signal blips ; Cos(#alpha); Counts", 800, -1, 1);
-// MC regA signal e+/e-
-TH1F* h_Blip_signal_mc_regA_energy_e    = new TH1F("h_Blip_signal_mc_regA_energy_e",   " MC regA-e signal blips ; Blip energy [MeV_{ee}]; Counts", 100, 0, 50);
-TH1F* h_Blip_signal_mc_regA_dist2vtx_e  = new TH1F("h_Blip_signal_mc_regA_dist2vtx_e", " MC regA-e signal blips ; Blip distance to shower vertex [cm]; Counts", 160, 0, 800);
-TH1F* h_Blip_signal_mc_regA_angle_e     = new TH1F("h_Blip_signal_mc_regA_angle_e",    " MC regA-e signal blips ; #alpha [degrees]; Counts", 36, 0, 180);
-TH1F* h_Blip_signal_mc_regA_cosangle_e  = new TH1F("h_Blip_signal_mc_regA_cosangle_e", " MC regA-e signal blips ; Cos(#alpha); Counts", 800, -1, 1);
-// MC regA signal heavy nuclei
-TH1F* h_Blip_signal_mc_regA_energy_HN    = new TH1F("h_Blip_signal_mc_regA_energy_HN",   " MC regA-HN signal blips ; Blip energy [MeV_{ee}]; Counts", 100, 0, 50);
-TH1F* h_Blip_signal_mc_regA_dist2vtx_HN  = new TH1F("h_Blip_signal_mc_regA_dist2vtx_HN", " MC regA-HN signal blips ; Blip distance to shower vertex [cm]; Counts", 160, 0, 800);
-TH1F* h_Blip_signal_mc_regA_angle_HN     = new TH1F("h_Blip_signal_mc_regA_angle_HN",    " MC regA-HN signal blips ; #alpha [degrees]; Counts", 36, 0, 180);
-TH1F* h_Blip_signal_mc_regA_cosangle_HN  = new TH1F("h_Blip_signal_mc_regA_cosangle_HN", " MC regA-HN signal blips ; Cos(#alpha); Counts", 800, -1, 1);
-// MC regA signal other
-TH1F* h_Blip_signal_mc_regA_energy_other    = new TH1F("h_Blip_signal_mc_regA_energy_other",   " MC regA-other signal blips ; Blip energy [MeV_{ee}]; Counts", 100, 0, 50);
-TH1F* h_Blip_signal_mc_regA_dist2vtx_other  = new TH1F("h_Blip_signal_mc_regA_dist2vtx_other", " MC regA-other signal blips ; Blip distance to shower vertex [cm]; Counts", 160, 0, 800);
-TH1F* h_Blip_signal_mc_regA_angle_other     = new TH1F("h_Blip_signal_mc_regA_angle_other",    " MC regA-other signal blips ; #alpha [degrees]; Counts", 36, 0, 180);
-TH1F* h_Blip_signal_mc_regA_cosangle_other  = new TH1F("h_Blip_signal_mc_regA_cosangle_other", " MC regA-other signal blips ; Cos(#alpha); Counts", 800, -1, 1);
-
-
-// -- MC Region B Signal blips ---
-TH1F* h_Blip_signal_mc_regB_energy    = new TH1F("h_Blip_signal_mc_regB_energy",   "MC regB signal blips ; Blip energy [MeV_{ee}]; Counts", 100, 0, 50);
-TH1F* h_Blip_signal_mc_regB_dist2vtx  = new TH1F("h_Blip_signal_mc_regB_dist2vtx", "MC regB signal blips ; Blip distance to shower vertex [cm]; Counts", 160, 0, 800);
-TH1F* h_Blip_signal_mc_regB_angle     = new TH1F("h_Blip_signal_mc_regB_angle",    "MC regB signal blips ; #alpha [degrees]; Counts", 36, 0, 180);
-TH1F* h_Blip_signal_mc_regB_cosangle  = new TH1F("h_Blip_signal_mc_regB_cosangle", "MC regB signal blips ; Cos(#alpha); Counts", 800, -1, 1);
-// MC regB signal p
-TH1F* h_Blip_signal_mc_regB_energy_p    = new TH1F("h_Blip_signal_mc_regB_energy_p",   "MC regB-p signal blips ; Blip energy [MeV_{ee}]; Counts", 100, 0, 50);
-TH1F* h_Blip_signal_mc_regB_dist2vtx_p  = new TH1F("h_Blip_signal_mc_regB_dist2vtx_p", "MC regB-p signal blips ; Blip distance to shower vertex [cm]; Counts", 160, 0, 800);
-TH1F* h_Blip_signal_mc_regB_angle_p     = new TH1F("h_Blip_signal_mc_regB_angle_p",    "MC regB-p signal blips ; #alpha [degrees]; Counts", 36, 0, 180);
-TH1F* h_Blip_signal_mc_regB_cosangle_p  = new TH1F("h_Blip_signal_mc_regB_cosangle_p", "MC regB-p signal blips ; Cos(#alpha); Counts", 800, -1, 1);
-// MC regB signal e+/e-
-TH1F* h_Blip_signal_mc_regB_energy_e    = new TH1F("h_Blip_signal_mc_regB_energy_e",   " MC regB-e signal blips ; Blip energy [MeV_{ee}]; Counts", 100, 0, 50);
-TH1F* h_Blip_signal_mc_regB_dist2vtx_e  = new TH1F("h_Blip_signal_mc_regB_dist2vtx_e", " MC regB-e signal blips ; Blip distance to shower vertex [cm]; Counts", 160, 0, 800);
-TH1F* h_Blip_signal_mc_regB_angle_e     = new TH1F("h_Blip_signal_mc_regB_angle_e",    " MC regB-e signal blips ; #alpha [degrees]; Counts", 36, 0, 180);
-TH1F* h_Blip_signal_mc_regB_cosangle_e  = new TH1F("h_Blip_signal_mc_regB_cosangle_e", " MC regB-e signal blips ; Cos(#alpha); Counts", 800, -1, 1);
-// MC regB signal heavy nuclei
-TH1F* h_Blip_signal_mc_regB_energy_HN    = new TH1F("h_Blip_signal_mc_regB_energy_HN",   " MC regB-HN signal blips ; Blip energy [MeV_{ee}]; Counts", 100, 0, 50);
-TH1F* h_Blip_signal_mc_regB_dist2vtx_HN  = new TH1F("h_Blip_signal_mc_regB_dist2vtx_HN", " MC regB-HN signal blips ; Blip distance to shower vertex [cm]; Counts", 160, 0, 800);
-TH1F* h_Blip_signal_mc_regB_angle_HN     = new TH1F("h_Blip_signal_mc_regB_angle_HN",    " MC regB-HN signal blips ; #alpha [degrees]; Counts", 36, 0, 180);
-TH1F* h_Blip_signal_mc_regB_cosangle_HN  = new TH1F("h_Blip_signal_mc_regB_cosangle_HN", " MC regB-HN signal blips ; Cos(#alpha); Counts", 800, -1, 1);
-// MC regB signal other
-TH1F* h_Blip_signal_mc_regB_energy_other    = new TH1F("h_Blip_signal_mc_regB_energy_other",   " MC regB-other signal blips ; Blip energy [MeV_{ee}]; Counts", 100, 0, 50);
-TH1F* h_Blip_signal_mc_regB_dist2vtx_other  = new TH1F("h_Blip_signal_mc_regB_dist2vtx_other", " MC regB-other signal blips ; Blip distance to shower vertex [cm]; Counts", 160, 0, 800);
-TH1F* h_Blip_signal_mc_regB_angle_other     = new TH1F("h_Blip_signal_mc_regB_angle_other",    " MC regB-other signal blips ; #alpha [degrees]; Counts", 36, 0, 180);
-TH1F* h_Blip_signal_mc_regB_cosangle_other  = new TH1F("h_Blip_signal_mc_regB_cosangle_other", " MC regB-other signal blips ; Cos(#alpha); Counts", 800, -1, 1);
-
-
-
-// -- Overlay Signal blips ---
-TH1F* h_Blip_signal_over_energy    = new TH1F("h_Blip_signal_over_energy",   "Overlay signal blips ; Blip energy [MeV_{ee}]; Counts", 100, 0, 50);
-TH1F* h_Blip_signal_over_dist2vtx  = new TH1F("h_Blip_signal_over_dist2vtx", "Overlay signal blips ; Blip distance to shower vertex [cm]; Counts", 160, 0, 800);
-TH1F* h_Blip_signal_over_angle     = new TH1F("h_Blip_signal_over_angle",    "Overlay signal blips ; #alpha [degrees]; Counts", 36, 0, 180);
-TH1F* h_Blip_signal_over_cosangle  = new TH1F("h_Blip_signal_over_cosangle", "Overlay signal blips ; Cos(#alpha); Counts", 800, -1, 1);
-// Overlay Reg A Signal blips
-TH1F* h_Blip_signal_over_regA_energy    = new TH1F("h_Blip_signal_over_regA_energy",   "Overlay regA signal blips ; Blip energy [MeV_{ee}]; Counts", 100, 0, 50);
-TH1F* h_Blip_signal_over_regA_dist2vtx  = new TH1F("h_Blip_signal_over_regA_dist2vtx", "Overlay regA signal blips ; Blip distance to shower vertex [cm]; Counts", 160, 0, 800);
-TH1F* h_Blip_signal_over_regA_angle     = new TH1F("h_Blip_signal_over_regA_angle",    "Overlay regA signal blips ; #alpha [degrees]; Counts", 36, 0, 180);
-TH1F* h_Blip_signal_over_regA_cosangle  = new TH1F("h_Blip_signal_over_regA_cosangle", "Overlay regA signal blips ; Cos(#alpha); Counts", 800, -1, 1);
-// Overlay Reg B Signal blips
-TH1F* h_Blip_signal_over_regB_energy    = new TH1F("h_Blip_signal_over_regB_energy",   "Overlay regB signal blips ; Blip energy [MeV_{ee}]; Counts", 100, 0, 50);
-TH1F* h_Blip_signal_over_regB_dist2vtx  = new TH1F("h_Blip_signal_over_regB_dist2vtx", "Overlay regB signal blips ; Blip distance to shower vertex [cm]; Counts", 160, 0, 800);
-TH1F* h_Blip_signal_over_regB_angle     = new TH1F("h_Blip_signal_over_regB_angle",    "Overlay regB signal blips ; #alpha [degrees]; Counts", 36, 0, 180);
-TH1F* h_Blip_signal_over_regB_cosangle  = new TH1F("h_Blip_signal_over_regB_cosangle", "Overlay regB signal blips ; Cos(#alpha); Counts", 800, -1, 1);
 
+// Chains the trees of all input files, binds the set_vars branch variables
+// and applies the branch manifest. Called once in serial mode and once per
+// worker otherwise (with only the worker's files), so every worker has its
+// own file handles and baskets.
+bool OpenInput(const std::vector<std::string>& files, bool UseBranchManifest, InputSet& input) {
 
+    input.files = files;
+    input.isSkim = IsSkimFile(files[0]);
 
+    // --- Get TTree ---
+    // A skim has all the branches in one tree (skim.h)
+    std::vector<const char*> treePaths = { kPeLEETree, kPFevalTree, kKINETree, kBDTTree, kEvalTree, kPOTTree };
+    if (input.isSkim) treePaths = { kSkimTree, kPOTTree };
+    for (const char* path : treePaths) {
+        TChain* chain = new TChain(path);
+        input.chains.push_back(chain);
+        for (const std::string& file : files) {
+            // nentries = 0 reads the tree header now, so a missing file or tree fails here
+            if (chain->Add(file.c_str(), 0) == 0) {
+                std::cerr << "Error: cannot find tree '" << path << "' in " << file << std::endl;
+                CloseInput(input);
+                return false;
+            }
+        }
+    }
 
+    TChain* fTree      = input.chains[0]; // PeLEE TTree
+    TChain* T_PFeval   = input.isSkim ? fTree : input.chains[1];
+    TChain* T_KINEvars = input.isSkim ? fTree : input.chains[2];
+    TChain* T_BDTvars  = input.isSkim ? fTree : input.chains[3];
+    TChain* T_eval     = input.isSkim ? fTree : input.chains[4];
+
+    // The Wire-Cell trees are filled together, so they must have the same
+    // number of entries in each file
+    for (size_t k = 1; k < 4 && !input.isSkim; ++k) {
+        for (size_t iFile = 1; iFile <= files.size(); ++iFile) {
+            if (input.chains[k]->GetTreeOffset()[iFile] != T_eval->GetTreeOffset()[iFile]) {
+                std::cerr << "Error: " << treePaths[k] << " and " << kEvalTree
+                          << " have different numbers of entries in " << files[iFile - 1] << std::endl;
+                CloseInput(input);
+                return false;
+            }
+        }
+    }
 
 
+    // Set the branches you plan on using; this function is in the "set_vars.h"
+    // file sourced at the top, along with all the variables.
+    // On a skim each function only finds its own branches: silence the
+    // "unknown branch" errors for the others.
+    Int_t errorLevel = gErrorIgnoreLevel;
+    if (input.isSkim) gErrorIgnoreLevel = kFatal;
+    setBranches(fTree); // blip info
+    setBranchesPFEval(T_PFeval);
+    setBranchesKINE(T_KINEvars);
+    setBranchesBDT(T_BDTvars);
+    setBranchesEval(T_eval);
+    gErrorIgnoreLevel = errorLevel;
+
+    // Only read the branches the selection uses (branch_manifest.h)
+    input.trees = {
+        {kPeLEETree,  fTree,      0},
+        {kPFevalTree, T_PFeval,   0},
+        {kKINETree,   T_KINEvars, 0},
+        {kBDTTree,    T_BDTvars,  0},
+        {kEvalTree,   T_eval,     0},
+    };
+    if (UseBranchManifest) {
+        if (input.isSkim) fTree->SetBranchStatus("*", false);
+        for (InputTree& in : input.trees) ApplyBranchManifest(in.tree, in.path, !input.isSkim);
+    }
+    return true;
+}
 
-    // --- Event loop ---
-    float Radius = 75;
 
-    int WC_0p_wBB = 0,  WC_Np_wBB = 0; 
-    int signal_events = 0;
-    int NoSigNorBkg = 0; int NoSigNorBkg0n = 0; int NoSigNorBkgNn = 0; 
-    int dummycounter = 0;   
-   // int nevents = fTree->GetEntries(); 
+// Matches the Wire-Cell entries to the PeLEE entries by run/subrun/event
+// (event_alignment.h); BDT and KINE follow T_eval. Reads the event ids of the
+// whole chain, so it is called once, in the parent: the work units get their
+// slice of the entry maps (MakeWorkUnits).
+bool AlignInput(InputSet& input) {
+    if (input.isSkim) return true;
+    std::vector<Long64_t> evalMap, pfevalMap;
+    if (!CheckAlignment(input.files, input.chains[0], input.chains[4], kEvalTree, evalMap) ||
+        !CheckAlignment(input.files, input.chains[0], input.chains[1], kPFevalTree, pfevalMap))
+        return false;
+    input.trees[1].entryMap = pfevalMap;
+    input.trees[2].entryMap = evalMap;
+    input.trees[3].entryMap = evalMap;
+    input.trees[4].entryMap = evalMap;
+    return true;
+}
 
-    int nevents = IsData ?  fTree->GetEntries() * 0.5   :  fTree->GetEntries() ;
-    std::cout << "fTree->GetEntries() " << fTree->GetEntries() << std::endl;
-    std::cout << "Total events: " << nevents << std::endl;
 
-    for (int iEvent = 0; iEvent < nevents; ++iEvent) {
-                fTree->GetEntry(iEvent);
-	            T_PFeval->GetEntry(iEvent);
-	            T_KINEvars->GetEntry(iEvent);
-                T_BDTvars->GetEntry(iEvent);
-                T_eval->GetEntry(iEvent);
+// Moves the --cutflow counts and loop time of this process into the cut flow
+// histograms of every pass (before a shard is written or the output closed)
+void FlushCutFlows(std::vector<std::unique_ptr<SelectionPass>>& passes) {
+    if (!gCutFlow.enabled) return;
+    for (auto& pass : passes) pass->cutflow.Flush(gCutFlow.seconds);
+    std::fill(gCutFlow.seconds, gCutFlow.seconds + kNLoopStages, 0.0);
+}
 
+// Same for the --bdt-scan records of this process: binned by every pass
+void FlushBDTScan(std::vector<std::unique_ptr<SelectionPass>>& passes) {
+    if (!gBDTScan.enabled) return;
+    for (auto& pass : passes) pass->bdtScan.Bin(gBDTScan.records, pass->variant.AddBacktrackedBlips);
+    gBDTScan.records.clear();
+}
 
-                TVector3 NuVtx(reco_nu_vtx_x, reco_nu_vtx_y, reco_nu_vtx_z); // NuVtx
-                TVector3 ShVtx(reco_showervtxX, reco_showervtxY, reco_showervtxZ); // ShVtx
-                TVector3 ShowerMomentum(reco_showerMomentum[0], reco_showerMomentum[1], reco_showerMomentum[2]); // ShowerDir
-   
 
-                int N_rec_protons = 0 , WC_N_rec_protons = 0 ;
-                int n_sig_blips = 0, n_sig_blips_mc = 0, n_sig_blips_overlay = 0 ; 
-                float SumE_sig_blips = 0, SumE_sig_blips_mc = 0, SumE_sig_blips_overlay = 0  ;          
+// Runs the selection on the entries of [first, last) kept by the prescale,
+// filling the skim tree (if any) with every entry that passes at least one
+// variant, or the score independent cuts with --bdt-scan.
+// Returns the number of entries whose full payload (blips, kine, truth) was read.
+long RunEventLoop(std::vector<InputTree>& inputs, std::vector<std::unique_ptr<SelectionPass>>& passes,
+                  bool UseBranchManifest, long first, long last, TTree* skim = nullptr) {
+
+    long npayload = 0;
+    std::vector<SelectionPass*> passing;   // variants whose preselection the current event passes
+    BlipBatch blips;                       // blips of the current event, shared by all variants
+    EventSummary event;                    // branch level summary of the current event (event_summary.h)
+    StageTimer timer;                      // --cutflow
+    if (gCutFlow.enabled) timer.Start();
+
+    for (long iEvent = first; iEvent < last; ++iEvent) {
+                // Phase one: preselection scalars only (everything with --all-branches)
+                if (!HasEvent(inputs, iEvent)) continue;   // not in every tree (event_alignment.h)
+                if (gReadCache.enabled()) CountCacheEntry(inputs, iEvent);   // read_cache.h
+                // The prescale first, on the PeLEE event id alone (event_range.h)
+                if (UseBranchManifest) {
+                    for (InputTree& in : inputs) ReadPrescaleBranches(in, iEvent);
+                    if (!PassesPrescale(run, sub, evt, gEventRange.prescale)) continue;
+                    for (InputTree& in : inputs) ReadCutBranches(in, iEvent);
+                } else {
+                    for (InputTree& in : inputs) ReadAllBranches(in, iEvent);
+                    if (!PassesPrescale(run, sub, evt, gEventRange.prescale)) continue;
+                }
+                gEventRange.accepted++;
+                if (gCutFlow.enabled) timer.Lap(kTimeReadCuts);
 
-		int n_sig_all_blips = 0 , n_sig_all_regA_blips = 0 ,n_sig_all_regB_blips = 0 ,n_sig_mc_blips = 0 ,n_sig_mc_regA_blips = 0 ,n_sig_mc_regB_blips = 0 ,n_sig_over_blips = 0 ,n_sig_over_regA_blips = 0 ,n_sig_over_regB_blips = 0 ;
-		float SumE_sig_all_blips = 0 , SumE_sig_all_regA_blips = 0 ,SumE_sig_all_regB_blips = 0 ,SumE_sig_mc_blips = 0 ,SumE_sig_mc_regA_blips = 0 ,SumE_sig_mc_regB_blips = 0 ,SumE_sig_over_blips = 0 ,SumE_sig_over_regA_blips = 0 ,SumE_sig_over_regB_blips = 0 ;
-   
-                        if (iEvent < 0)
-                         std::cout << "Event " << iEvent << " nblips_saved=" << nblips_saved
-                            << " blip_energy size=" << (blip_energy ? blip_energy->size() : 0)
-                            <<"\n  NuSelFil-reco_nuvtx(x,y,z): "<<reco_nu_vtx_x<<","<<reco_nu_vtx_y<<","<<reco_nu_vtx_z 
-		                    <<"\n  PFEv-reco_nuvtx(x,y,z): "<<reco_nuvtxX<<","<<reco_nuvtxY<<","<<reco_nuvtxZ
-		                    <<"\n  PFEv-reco_showervtx(x,y,z): "<<reco_showervtxX<<","<<reco_showervtxY<<","<<reco_showervtxZ
-		                    <<"\n  PFEv-ShDirection(x,y,z): "<<reco_showerMomentum[0]<<","<<reco_showerMomentum[1]<<","<<reco_showerMomentum[2]
-		                    <<"\n KINE-kine_reco_Enu: "<<kine_reco_Enu 
-		                    <<"\n BDT-single_photon_numu_score: "<<single_photon_numu_score
-                            <<"\n BDT-single_photon_other_score: "<<single_photon_other_score
-		                    <<"\n BDT-single_photon_ncpi0_score: "<<single_photon_ncpi0_score
-		                    <<"\n BDT-single_photon_nue_score: "<<single_photon_nue_score
-
-                            <<"\n Eval-match_completeness_energy: "<<match_completeness_energy
-                            <<"\n Eval-truth_energyInside: "<<truth_energyInside
-		                    <<"\n PFEv-truth_single_photon: "<<truth_single_photon
-		                    <<"\n Eval-truth_isCC: "<<truth_isCC
-			                <<"\n PFEv-truth_NCDelta: "<<truth_NCDelta
-			                <<"\n Eval-truth_vtxInside: "<<truth_vtxInside
-		                    << std::endl;
 
 			                    //********************************
 			                    //  1gX- selection + generic neutrino selection
 			                    //********************************  
-			                if ( 
-				    crtveto == 0 && 	
-                                    kine_reco_Enu > 0   &&  /* LEEana::is_singlephoton_sel(tagger, pfeval)*/
-
-                                    shw_sp_n_20mev_showers > 0 &&
-                                    reco_nuvtxX>5.0 && reco_nuvtxX<250.0 &&
-                                    single_photon_numu_score > 0.4 &&
-                                    single_photon_other_score > 0.2 &&
-                                    single_photon_ncpi0_score > -0.05 &&
-                                    single_photon_nue_score > -1.0 &&
-                                    shw_sp_n_20br1_showers==1
-
-	                             ){//Signal Events
-			
-			                        signal_events++ ; 
-
-                                    if (signal_events < 0)
-                                    std::cout << "Signal Event " << iEvent << " nblips_saved=" << nblips_saved
-                                    << " blip_energy size=" << (blip_energy ? blip_energy->size() : 0)
-                                    <<"\n  NuSelFil-reco_nuvtx(x,y,z): "<<reco_nu_vtx_x<<","<<reco_nu_vtx_y<<","<<reco_nu_vtx_z
-                                    <<"\n  PFEv-reco_nuvtx(x,y,z): "<<reco_nuvtxX<<","<<reco_nuvtxY<<","<<reco_nuvtxZ
-                                    <<"\n  PFEv-reco_showervtx(x,y,z): "<<reco_showervtxX<<","<<reco_showervtxY<<","<<reco_showervtxZ
-                                    <<"\n  PFEv-ShDirection(x,y,z): "<<reco_showerMomentum[0]<<","<<reco_showerMomentum[1]<<","<<reco_showerMomentum[2]
-                                    <<"\n KINE-kine_reco_Enu: "<<kine_reco_Enu
-                                    <<"\n BDT-single_photon_numu_score: "<<single_photon_numu_score
-                                    <<"\n BDT-single_photon_other_score: "<<single_photon_other_score
-                                    <<"\n BDT-single_photon_ncpi0_score: "<<single_photon_ncpi0_score
-                                    <<"\n BDT-single_photon_nue_score: "<<single_photon_nue_score
-
-                                    <<"\n Eval-match_completeness_energy: "<<match_completeness_energy
-                                    <<"\n Eval-truth_energyInside: "<<truth_energyInside
-                                    <<"\n PFEv-truth_single_photon: "<<truth_single_photon
-                                    <<"\n Eval-truth_isCC: "<<truth_isCC
-                                    <<"\n PFEv-truth_NCDelta: "<<truth_NCDelta
-                                    <<"\n Eval-truth_vtxInside: "<<truth_vtxInside
-                                    << std::endl;
-
-                                    
-
-                                    //-- Blip section --
-                                        
-                                     int backtracked_blip = 0 ;  
-                                     // --- Blip loop ---
-                                     for (size_t iBlip = 0; iBlip < nblips_saved ; ++iBlip) {
-
-                                        TVector3 BlipVtx(blip_x->at(iBlip), blip_y->at(iBlip) , blip_z->at(iBlip));
-                                        TVector3 ShowerVtx2Blip = BlipVtx - ShVtx; // Vector
-		                                float blip_dist2vtx = (BlipVtx - ShVtx).Mag(); // Blip dist w.r.t ShVtx
-
-
-                                        if (blip_nplanes->at(iBlip) > 1 &&          // 2&3 matched-planes (3D-blips)
-                                            blip_touchtrk->at(iBlip) == 0 &&        // No blips touching tracks
-                                            blip_pl2_bydeadwire->at(iBlip) == 0 &&  // No blips by dead wires in collection plane (pl2)
-                                            blip_proxtrkdist->at(iBlip) > 15 &&      // Distance to closest track > 15 [cm]
-                                            blip_dist2vtx < Radius                      // Blip distance from ShVtx
-                                            //blip_energy->at(iBlip) > 0.6            // Reco blip energy > 0.6 [MeVee}
-                                            //IsWithinSphereOutsideConic(ShVtx, ShowerMomentum, BlipVtx, Radius) //Qsphere
-
-		                                    ){  
-
-                                         double blip_angle_sh = calculateAngleBetweenVectors(ShowerVtx2Blip, ShowerMomentum);
-                                         double cos_blip_angle_sh = calculateCosineAngleBetweenVectors(ShowerVtx2Blip, ShowerMomentum); 
-
-
-
-                                         //-- Sphere blips
-                                         //--All
-                                         h_Blip_sphere_all_energy  ->Fill(blip_energy->at(iBlip));
-                                         h_Blip_sphere_all_dist2vtx->Fill(blip_dist2vtx);
-                                         h_Blip_sphere_all_angle   ->Fill(blip_angle_sh);
-                                         h_Blip_sphere_all_cosangle->Fill(cos_blip_angle_sh);
-                                         
-                                         //Local MC-Overlay split
-                                         //-- MC
-                                         if (blip_true_g4id->at(iBlip) > 0) { 
-                                             h_Blip_sphere_all_energy_mc  ->Fill(blip_energy->at(iBlip));
-                                             h_Blip_sphere_all_dist2vtx_mc->Fill(blip_dist2vtx);
-                                             h_Blip_sphere_all_angle_mc   ->Fill(blip_angle_sh);
-                                             h_Blip_sphere_all_cosangle_mc->Fill(cos_blip_angle_sh);
-                                             // Truth match 
-                                             if (blip_true_pdg->at(iBlip) == 2212){ // truth matched proton blips
-                                                 h_Blip_sphere_all_energy_mc_p  ->Fill(blip_energy->at(iBlip));
-                                                 h_Blip_sphere_all_dist2vtx_mc_p->Fill(blip_dist2vtx);
-                                                 h_Blip_sphere_all_angle_mc_p   ->Fill(blip_angle_sh);
-                                                 h_Blip_sphere_all_cosangle_mc_p->Fill(cos_blip_angle_sh);      
-
-                                                } else if (blip_true_pdg->at(iBlip) ==   11 || blip_true_pdg->at(iBlip) ==   -11) {// truth matched e+/e- blips
-                                                            h_Blip_sphere_all_energy_mc_e  ->Fill(blip_energy->at(iBlip));
-                                                            h_Blip_sphere_all_dist2vtx_mc_e->Fill(blip_dist2vtx);
-                                                            h_Blip_sphere_all_angle_mc_e   ->Fill(blip_angle_sh);
-                                                            h_Blip_sphere_all_cosangle_mc_e->Fill(cos_blip_angle_sh);          
-                                                        }else if (blip_true_pdg->at(iBlip) == 1000010020 || // truth matched heavy nuclei-blips 1000010020-D 
-                                                                  blip_true_pdg->at(iBlip) == 1000010030 || // 1000010030-T
-                                                                  blip_true_pdg->at(iBlip) == 1000020030 || // 1000020030-He3
-			                                          blip_true_pdg->at(iBlip) == 1000020040 ){ // 1000020040-alpha
-                                            
-                                                                            h_Blip_sphere_all_energy_mc_HN  ->Fill(blip_energy->at(iBlip));
-                                                                            h_Blip_sphere_all_dist2vtx_mc_HN->Fill(blip_dist2vtx);
-                                                                            h_Blip_sphere_all_angle_mc_HN   ->Fill(blip_angle_sh);
-                                                                            h_Blip_sphere_all_cosangle_mc_HN->Fill(cos_blip_angle_sh);
-                                                                }else{ // other truth match
-                                                                    h_Blip_sphere_all_energy_mc_other  ->Fill(blip_energy->at(iBlip));
-                                                                    h_Blip_sphere_all_dist2vtx_mc_other->Fill(blip_dist2vtx);
-                                                                    h_Blip_sphere_all_angle_mc_other   ->Fill(blip_angle_sh);
-                                                                    h_Blip_sphere_all_cosangle_mc_other->Fill(cos_blip_angle_sh);
-
-                                                                }// End Truth match
-
-
-                                                //-- Overlay
-                                             }else{ h_Blip_sphere_all_energy_over  ->Fill(blip_energy->at(iBlip));
-                                                    h_Blip_sphere_all_dist2vtx_over->Fill(blip_dist2vtx);
-                                                    h_Blip_sphere_all_angle_over   ->Fill(blip_angle_sh);
-                                                    h_Blip_sphere_all_cosangle_over->Fill(cos_blip_angle_sh); }
-                                    
-                                          //-- End Sphere blips
-
-
-                                         //--------------------------
-                                         //-- Signal blips section --
-                                         //--------------------------
-                                           if( IsWithinSphereOutsideConic(ShVtx, ShowerMomentum, BlipVtx, Radius) ){ //Qsphere
-                                                
-                                                 //--Signal All
-                                                  n_sig_all_blips++ ; SumE_sig_all_blips+= blip_energy->at(iBlip) ;
-
-                                                    h_Blip_signal_all_energy  ->Fill(blip_energy->at(iBlip));
-                                                    h_Blip_signal_all_dist2vtx->Fill(blip_dist2vtx);
-                                                    h_Blip_signal_all_angle   ->Fill(blip_angle_sh);
-                                                    h_Blip_signal_all_cosangle->Fill(cos_blip_angle_sh);
-
-                                                    
-
-                                                    // Region B all
-                                                    if( IsBackTrackedBlip( blip_dist2vtx , cos_blip_angle_sh ) ) { 
-                                                        n_sig_all_regB_blips++ ; SumE_sig_all_regB_blips+= blip_energy->at(iBlip) ;
-                                                        h_Blip_signal_all_regB_energy  ->Fill(blip_energy->at(iBlip));
-                                                        h_Blip_signal_all_regB_dist2vtx->Fill(blip_dist2vtx);
-                                                        h_Blip_signal_all_regB_angle   ->Fill(blip_angle_sh);
-                                                        h_Blip_signal_all_regB_cosangle->Fill(cos_blip_angle_sh);
-
-
-
-                                                     //Region A all
-                                                    }else{  
-                                                        n_sig_all_regA_blips++ ; SumE_sig_all_regA_blips+= blip_energy->at(iBlip) ;
-                                                        h_Blip_signal_all_regA_energy  ->Fill(blip_energy->at(iBlip));
-                                                        h_Blip_signal_all_regA_dist2vtx->Fill(blip_dist2vtx);
-                                                        h_Blip_signal_all_regA_angle   ->Fill(blip_angle_sh);
-                                                        h_Blip_signal_all_regA_cosangle->Fill(cos_blip_angle_sh);
-                                                    }
-
-
-
-
-
-
-
-                                                 //--Signal MC
-                                                if (blip_true_g4id->at(iBlip) > 0) {
-                                                     n_sig_mc_blips++ ; SumE_sig_mc_blips+= blip_energy->at(iBlip) ;
-                                                                                              
-
-                                                     //All MC
-                                                     h_Blip_signal_mc_energy  ->Fill(blip_energy->at(iBlip));
-                                                     h_Blip_signal_mc_dist2vtx->Fill(blip_dist2vtx);
-                                                     h_Blip_signal_mc_angle   ->Fill(blip_angle_sh);
-                                                     h_Blip_signal_mc_cosangle->Fill(cos_blip_angle_sh);
-
-                                                     // Truth match 
-                                                     if (blip_true_pdg->at(iBlip) == 2212){ // truth matched proton blips
-                                                        h_Blip_signal_mc_energy_p  ->Fill(blip_energy->at(iBlip));
-                                                        h_Blip_signal_mc_dist2vtx_p->Fill(blip_dist2vtx);
-                                                        h_Blip_signal_mc_angle_p   ->Fill(blip_angle_sh);
-                                                        h_Blip_signal_mc_cosangle_p->Fill(cos_blip_angle_sh);
-                                                    
-                                                        } else if (blip_true_pdg->at(iBlip) ==   11 || blip_true_pdg->at(iBlip) ==   -11) {// truth matched e+/e- blips
-                                                                   h_Blip_signal_mc_energy_e  ->Fill(blip_energy->at(iBlip));
-                                                                   h_Blip_signal_mc_dist2vtx_e->Fill(blip_dist2vtx);
-                                                                   h_Blip_signal_mc_angle_e   ->Fill(blip_angle_sh);
-                                                                   h_Blip_signal_mc_cosangle_e->Fill(cos_blip_angle_sh);
-
-                                                                } else if (blip_true_pdg->at(iBlip) == 1000010020 || // truth matched heavy nuclei-blips 1000010020-D 
-                                                                           blip_true_pdg->at(iBlip) == 1000010030 || // 1000010030-T
-                                                                           blip_true_pdg->at(iBlip) == 1000020030 || // 1000020030-He3
-			                                                   blip_true_pdg->at(iBlip) == 1000020040 ){ // 1000020040-alpha
-                                                                                    h_Blip_signal_mc_energy_HN  ->Fill(blip_energy->at(iBlip));
-                                                                                    h_Blip_signal_mc_dist2vtx_HN->Fill(blip_dist2vtx);
-                                                                                    h_Blip_signal_mc_angle_HN   ->Fill(blip_angle_sh);
-                                                                                    h_Blip_signal_mc_cosangle_HN->Fill(cos_blip_angle_sh);
-                                                                            
-                                                                        } else{ // other truth match
-                                                                                h_Blip_signal_mc_energy_other  ->Fill(blip_energy->at(iBlip));
-                                                                                h_Blip_signal_mc_dist2vtx_other->Fill(blip_dist2vtx);
-                                                                                h_Blip_signal_mc_angle_other   ->Fill(blip_angle_sh);
-                                                                                h_Blip_signal_mc_cosangle_other->Fill(cos_blip_angle_sh);
-                                                        
-                                                                                }// End Truth match
-
-
-
-
-
-                                                    // MC Region B 
-                                                    if( IsBackTrackedBlip( blip_dist2vtx , cos_blip_angle_sh ) ) { 
-                                                        n_sig_mc_regB_blips++ ; SumE_sig_mc_regB_blips+= blip_energy->at(iBlip) ;
-
-                                                        h_Blip_signal_mc_regB_energy  ->Fill(blip_energy->at(iBlip));
-                                                        h_Blip_signal_mc_regB_dist2vtx->Fill(blip_dist2vtx);
-                                                        h_Blip_signal_mc_regB_angle   ->Fill(blip_angle_sh);
-                                                        h_Blip_signal_mc_regB_cosangle->Fill(cos_blip_angle_sh);
-
-                                                        
-
-                                                     // Truth match Region B 
-                                                     if (blip_true_pdg->at(iBlip) == 2212){ // truth matched proton blips
-                                                        h_Blip_signal_mc_regB_energy_p  ->Fill(blip_energy->at(iBlip));
-                                                        h_Blip_signal_mc_regB_dist2vtx_p->Fill(blip_dist2vtx);
-                                                        h_Blip_signal_mc_regB_angle_p   ->Fill(blip_angle_sh);
-                                                        h_Blip_signal_mc_regB_cosangle_p->Fill(cos_blip_angle_sh);
-                                                    
-                                                        } else if (blip_true_pdg->at(iBlip) ==   11 || blip_true_pdg->at(iBlip) ==   -11) {// truth matched e+/e- blips
-                                                                   h_Blip_signal_mc_regB_energy_e  ->Fill(blip_energy->at(iBlip));
-                                                                   h_Blip_signal_mc_regB_dist2vtx_e->Fill(blip_dist2vtx);
-                                                                   h_Blip_signal_mc_regB_angle_e   ->Fill(blip_angle_sh);
-                                                                   h_Blip_signal_mc_regB_cosangle_e->Fill(cos_blip_angle_sh);
-
-                                                                } else if (blip_true_pdg->at(iBlip) == 1000010020 || // truth matched heavy nuclei-blips 1000010020-D, 
-                                                                           blip_true_pdg->at(iBlip) == 1000010030 || //1000010030-T,
-                                                                           blip_true_pdg->at(iBlip) == 1000020030 || //1000020030-He3
-			                                                   blip_true_pdg->at(iBlip) == 1000020040 ){ //1000020040-alpha
-                                                                                    h_Blip_signal_mc_regB_energy_HN  ->Fill(blip_energy->at(iBlip));
-                                                                                    h_Blip_signal_mc_regB_dist2vtx_HN->Fill(blip_dist2vtx);
-                                                                                    h_Blip_signal_mc_regB_angle_HN   ->Fill(blip_angle_sh);
-                                                                                    h_Blip_signal_mc_regB_cosangle_HN->Fill(cos_blip_angle_sh);
-                                                                            
-                                                                        } else{ // other truth match
-                                                                                h_Blip_signal_mc_regB_energy_other  ->Fill(blip_energy->at(iBlip));
-                                                                                h_Blip_signal_mc_regB_dist2vtx_other->Fill(blip_dist2vtx);
-                                                                                h_Blip_signal_mc_regB_angle_other   ->Fill(blip_angle_sh);
-                                                                                h_Blip_signal_mc_regB_cosangle_other->Fill(cos_blip_angle_sh);
-                                                        
-                                                                                 }// End Truth match Region B
-
-
-
-
-
-
-                                                     // MC Region A 
-                                                    }else{  
-                                                        n_sig_mc_regA_blips++ ; SumE_sig_mc_regA_blips+= blip_energy->at(iBlip) ;
-                                                        h_Blip_signal_mc_regA_energy  ->Fill(blip_energy->at(iBlip));
-                                                        h_Blip_signal_mc_regA_dist2vtx->Fill(blip_dist2vtx);
-                                                        h_Blip_signal_mc_regA_angle   ->Fill(blip_angle_sh);
-                                                        h_Blip_signal_mc_regA_cosangle->Fill(cos_blip_angle_sh);
-
-
-
-                                                        // Truth match Region A
-                                                     if (blip_true_pdg->at(iBlip) == 2212){ // truth matched proton blips
-                                                        h_Blip_signal_mc_regA_energy_p  ->Fill(blip_energy->at(iBlip));
-                                                        h_Blip_signal_mc_regA_dist2vtx_p->Fill(blip_dist2vtx);
-                                                        h_Blip_signal_mc_regA_angle_p   ->Fill(blip_angle_sh);
-                                                        h_Blip_signal_mc_regA_cosangle_p->Fill(cos_blip_angle_sh);
-                                                    
-                                                        } else if (blip_true_pdg->at(iBlip) ==   11 || blip_true_pdg->at(iBlip) ==   -11) {// truth matched e+/e- blips
-                                                                   h_Blip_signal_mc_regA_energy_e  ->Fill(blip_energy->at(iBlip));
-                                                                   h_Blip_signal_mc_regA_dist2vtx_e->Fill(blip_dist2vtx);
-                                                                   h_Blip_signal_mc_regA_angle_e   ->Fill(blip_angle_sh);
-                                                                   h_Blip_signal_mc_regA_cosangle_e->Fill(cos_blip_angle_sh);
-
-                                                                } else if (blip_true_pdg->at(iBlip) == 1000010020 || // truth matched heavy nuclei-blips 1000010020-D, 
-                                                                           blip_true_pdg->at(iBlip) == 1000010030 || // 1000010030-T
-                                                                           blip_true_pdg->at(iBlip) == 1000020030 || // 1000020030-He3
-			                                                   blip_true_pdg->at(iBlip) == 1000020040 ){ // 1000020040-alpha
-                                                                                    h_Blip_signal_mc_regA_energy_HN  ->Fill(blip_energy->at(iBlip));
-                                                                                    h_Blip_signal_mc_regA_dist2vtx_HN->Fill(blip_dist2vtx);
-                                                                                    h_Blip_signal_mc_regA_angle_HN   ->Fill(blip_angle_sh);
-                                                                                    h_Blip_signal_mc_regA_cosangle_HN->Fill(cos_blip_angle_sh);
-                                                                            
-                                                                        } else{ // other truth match
-                                                                                h_Blip_signal_mc_regA_energy_other  ->Fill(blip_energy->at(iBlip));
-                                                                                h_Blip_signal_mc_regA_dist2vtx_other->Fill(blip_dist2vtx);
-                                                                                h_Blip_signal_mc_regA_angle_other   ->Fill(blip_angle_sh);
-                                                                                h_Blip_signal_mc_regA_cosangle_other->Fill(cos_blip_angle_sh);
-                                                        
-                                                                                }// End Truth match Region A
-
-
-                                                    }//End MC Region A
-
-
-                                                                                         
-                                                 
-
-
-                                                 
-                                                 
-                                                 //--Signal Overlay
-                                                 }else{ //All Overlay
-                                                 n_sig_over_blips++ ; SumE_sig_over_blips+= blip_energy->at(iBlip) ; 
-                                                
-                                                    h_Blip_signal_over_energy  ->Fill(blip_energy->at(iBlip));
-                                                    h_Blip_signal_over_dist2vtx->Fill(blip_dist2vtx);
-                                                    h_Blip_signal_over_angle   ->Fill(blip_angle_sh);
-                                                    h_Blip_signal_over_cosangle->Fill(cos_blip_angle_sh);
-
-                                                    
-
-                                                    // Overlay Region B
-                                                    if( IsBackTrackedBlip( blip_dist2vtx , cos_blip_angle_sh ) ) { 
-                                                        n_sig_over_regB_blips++ ; SumE_sig_over_regB_blips+= blip_energy->at(iBlip) ;
-                                                        h_Blip_signal_over_regB_energy  ->Fill(blip_energy->at(iBlip));
-                                                        h_Blip_signal_over_regB_dist2vtx->Fill(blip_dist2vtx);
-                                                        h_Blip_signal_over_regB_angle   ->Fill(blip_angle_sh);
-                                                        h_Blip_signal_over_regB_cosangle->Fill(cos_blip_angle_sh);
-
-
-
-
-                                                    }else{ // Overlay Region A 
-                                                        n_sig_over_regA_blips++ ; SumE_sig_over_regA_blips+= blip_energy->at(iBlip) ;
-                                                        h_Blip_signal_over_regA_energy  ->Fill(blip_energy->at(iBlip));
-                                                        h_Blip_signal_over_regA_dist2vtx->Fill(blip_dist2vtx);
-                                                        h_Blip_signal_over_regA_angle   ->Fill(blip_angle_sh);
-                                                        h_Blip_signal_over_regA_cosangle->Fill(cos_blip_angle_sh);
-                                                    }
-
-
-                                                }//--Endoverlay Blips
-
-
-                                            } //--- End Signal blips
-			
-                                               
-                                        } //<--End Sphere blips
-                                    
+                PreselectionInputs presel = {
+                                    (double)crtveto,
+                                    (double)kine_reco_Enu,   /* LEEana::is_singlephoton_sel(tagger, pfeval)*/
+                                    (double)shw_sp_n_20mev_showers,
+                                    (double)reco_nuvtxX,
+                                    (double)single_photon_numu_score,
+                                    (double)single_photon_other_score,
+                                    (double)single_photon_ncpi0_score,
+                                    (double)single_photon_nue_score,
+                                    (double)shw_sp_n_20br1_showers };
+
+                passing.clear();
+                for (auto& pass : passes) {
+                    int failed = FirstFailedCut(pass->variant.cuts, presel);
+                    if (gCutFlow.enabled) pass->cutflow.CountEvent(failed);
+                    if (failed == kNPreselectionCuts) passing.push_back(pass.get());
+                }
+                if (gCutFlow.enabled) timer.Lap(kTimePreselection);
+                bool scanEvent = gBDTScan.enabled && PassesScoreIndependentCuts(presel);   // --bdt-scan
+                if (passing.empty() && !scanEvent) continue;
+
+                // Phase two: blips, kine arrays and truth, only for events some variant (or the BDT scan) keeps
+                if (UseBranchManifest)
+                    for (InputTree& in : inputs) ReadPayloadBranches(in, iEvent);
+                npayload++;
+                if (gCutFlow.enabled) timer.Lap(kTimeReadPayload);
+                if (skim) skim->Fill();   // passing events, and the --bdt-scan ones
+                if (gCutFlow.enabled) timer.Lap(kTimeSkim);
 
+                TVector3 NuVtx(reco_nu_vtx_x, reco_nu_vtx_y, reco_nu_vtx_z); // NuVtx
+                TVector3 ShVtx(reco_showervtxX, reco_showervtxY, reco_showervtxZ); // ShVtx
+                TVector3 ShowerMomentum(reco_showerMomentum[0], reco_showerMomentum[1], reco_showerMomentum[2]); // ShowerDir
 
+                blips.FillFromBranches();
+                SummarizeEvent(event);   // WC protons, 0p and truth category: once for all variants
+                if (gCutFlow.enabled) timer.Lap(kTimeBlipBatch);
+                if (scanEvent) RecordBDTScanEvent(presel, event, blips, ShVtx, ShowerMomentum, passes[0]->Radius);
+                for (SelectionPass* pass : passing) pass->FillEvent(blips, ShVtx, ShowerMomentum, event);
+                if (gCutFlow.enabled) timer.Lap(kTimeFill);
 
-                                    } //<-- End Blip Loop 
+                            }//<--End Event Loop
 
+    return npayload;
+}
 
 
+// Entries [first, last) of the chain of `files`, processed by one worker
+struct WorkUnit {
+    std::vector<std::string> files;
+    long first;
+    long last;
+    std::vector<std::vector<Long64_t>> entryMaps;   // per input tree, in the entry numbers of `files`
+};
 
 
+// Splits the input into work units: one per file when there are several
+// files, otherwise nWorkers contiguous entry ranges of the single file.
+// Only the entries [first, last) of the full chain are covered.
+std::vector<WorkUnit> MakeWorkUnits(const InputSet& input, int nWorkers, long first, long last) {
 
+    std::vector<std::vector<Long64_t>> entryMaps;
+    for (const InputTree& in : input.trees) entryMaps.push_back(in.entryMap);
 
+    std::vector<WorkUnit> units;
+    if (input.files.size() == 1) {
+        for (int i = 0; i < nWorkers; ++i)
+            units.push_back({input.files, first + (last - first) * i / nWorkers, first + (last - first) * (i + 1) / nWorkers,
+                             entryMaps});
+        return units;
+    }
 
+    // One file per unit: its part of each entry map, renumbered within the file
+    const Long64_t* offset = input.chains[0]->GetTreeOffset();
+    for (size_t iFile = 0; iFile < input.files.size(); ++iFile) {
+        long begin = std::max<long>(offset[iFile], first) - offset[iFile];
+        long end   = std::min<long>(offset[iFile + 1], last) - offset[iFile];
+        if (end <= begin) continue;
+        WorkUnit unit = {{input.files[iFile]}, begin, end, std::vector<std::vector<Long64_t>>(entryMaps.size())};
+        for (size_t k = 0; k < entryMaps.size(); ++k) {
+            if (entryMaps[k].empty()) continue;
+            Long64_t wcOffset = ((TChain*)input.trees[k].tree)->GetTreeOffset()[iFile];
+            for (Long64_t i = offset[iFile]; i < offset[iFile + 1]; ++i)
+                unit.entryMaps[k].push_back(entryMaps[k][i] < 0 ? -1 : entryMaps[k][i] - wcOffset);
+        }
+        units.push_back(unit);
+    }
+    return units;
+}
 
 
+// Runs the work units in forked worker processes, at most nWorkers at a time.
+// Worker skims are appended to `skim` in unit order.
+// The branch variables from the set_vars headers are process-wide globals, so
+// each worker owns its own copy of them, of every histogram and of the
+// counters. Workers write their shard to a scratch file and the parent adds
+// the shards back into its histograms (in unit order) before they are
+// written, so the output is the same as a serial run over the whole chain.
+bool RunParallel(int nWorkers, const std::vector<WorkUnit>& units, bool UseBranchManifest,
+                 std::vector<std::unique_ptr<SelectionPass>>& passes,
+                 std::vector<InputTree>& inputs, long& npayload, Long64_t& fileBytesRead, TTree* skim) {
+
+    std::vector<pid_t> workers(units.size(), -1);
+    std::vector<std::string> shardFiles;
+    for (size_t iUnit = 0; iUnit < units.size(); ++iUnit)
+        shardFiles.push_back(Form("%s/anamacro_shard_%d_%zu.root", gSystem->TempDirectory(), getpid(), iUnit));
+
+    bool ok = true;
+    size_t next = 0;
+    int running = 0;
+    while (running > 0 || (ok && next < units.size())) {
+
+        if (ok && next < units.size() && running < nWorkers) {
+            const WorkUnit& unit = units[next];
+
+            std::cout.flush();
+            pid_t pid = fork();
+            if (pid < 0) {
+                std::cerr << "ERROR: fork() failed for worker " << next << "\n";
+                ok = false;
+                continue;
+            }
+
+            if (pid == 0) { // --- worker ---
+                Long64_t bytesAtStart = TFile::GetFileBytesRead();
+                Long64_t readCallsAtStart = TFile::GetFileReadCalls();
+                InputSet input;
+                if (!OpenInput(unit.files, UseBranchManifest, input)) _exit(1);
+                for (size_t k = 0; k < input.trees.size(); ++k) input.trees[k].entryMap = unit.entryMaps[k];
+                SetUpReadCache(input.trees, UseBranchManifest, unit.first, unit.last);
+                if (gIOReport.enabled) StartIOReport(input.trees, true);
+
+                // Opened first so the worker's skim tree is written into the shard
+                TFile shard(shardFiles[next].c_str(), "RECREATE");
+                TTree* workerSkim = skim ? CreateSkimTree(input.trees) : nullptr;
+
+                long workerPayload = RunEventLoop(input.trees, passes, UseBranchManifest, unit.first, unit.last, workerSkim);
+                if (gIOReport.enabled) StopIOReport(input.trees);
+                CollectCacheStats(input.trees);
+
+                if (workerSkim) {
+                    shard.cd();
+                    workerSkim->Write();
+                }
+                FlushCutFlows(passes);
+                FlushBDTScan(passes);
+                for (size_t iVar = 0; iVar < passes.size(); ++iVar)
+                    passes[iVar]->WriteShard(shard.mkdir(Form("pass%zu", iVar)));
+
+                TDirectory* io = shard.mkdir("io");
+                if (gIOReport.enabled) WriteIOStats(io);
+                if (gReadCache.enabled()) WriteCacheStats(io);
+                io->cd();
+                for (size_t k = 0; k < input.trees.size(); ++k)
+                    TParameter<Long64_t>(Form("bytesRead_%zu", k), input.trees[k].bytesRead).Write();
+                TParameter<Long64_t>("npayload", workerPayload).Write();
+                TParameter<Long64_t>("fileBytesRead", TFile::GetFileBytesRead() - bytesAtStart).Write();
+                TParameter<Long64_t>("fileReadCalls", TFile::GetFileReadCalls() - readCallsAtStart).Write();
+                TParameter<Long64_t>("checkedBlips", gBlipKernelCheck.nblips).Write();
+                TParameter<Long64_t>("blipMismatches", gBlipKernelCheck.nmismatch).Write();
+                TParameter<Long64_t>("accepted", gEventRange.accepted).Write();
+                shard.Close();
+
+                std::cout.flush();
+                _exit(0);
+            }
+
+            std::cout << "Worker " << next << " (pid " << pid << "): "
+                      << (unit.files.size() == 1 ? unit.files[0] : std::to_string(unit.files.size()) + " files")
+                      << " entries [" << unit.first << ", " << unit.last << ")" << std::endl;
+            workers[next++] = pid;
+            running++;
+            continue;
+        }
+
+        // Pool full (or nothing left to start): wait for a worker to finish
+        int status = 0;
+        pid_t done = wait(&status);
+        if (done < 0) break;
+        running--;
+        size_t iWorker = std::find(workers.begin(), workers.end(), done) - workers.begin();
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            std::cerr << "ERROR: worker " << iWorker << " failed\n";
+            ok = false;
+        }
+    }
 
-                                    //Inclusive Single Photon channels
+    // Merge the shards in unit order
+    for (size_t iUnit = 0; iUnit < next; ++iUnit) {
+        const std::string& shardFile = shardFiles[iUnit];
+        TFile* shard = ok ? TFile::Open(shardFile.c_str()) : nullptr;
+        if (shard && !shard->IsZombie()) {
+            for (size_t iVar = 0; iVar < passes.size(); ++iVar)
+                ok = passes[iVar]->MergeShard(shard->GetDirectory(Form("pass%zu", iVar))) && ok;
+
+            TDirectory* io = shard->GetDirectory("io");
+            for (size_t k = 0; k < inputs.size(); ++k) {
+                TParameter<Long64_t>* bytes = nullptr;
+                io->GetObject(Form("bytesRead_%zu", k), bytes);
+                if (bytes) inputs[k].bytesRead += bytes->GetVal();
+            }
+            TParameter<Long64_t>* payload = nullptr;
+            io->GetObject("npayload", payload);
+            if (payload) npayload += payload->GetVal();
+            TParameter<Long64_t>* fileBytes = nullptr;
+            io->GetObject("fileBytesRead", fileBytes);
+            if (fileBytes) fileBytesRead += fileBytes->GetVal();
+            TParameter<Long64_t>* readCalls = nullptr;
+            io->GetObject("fileReadCalls", readCalls);
+            if (readCalls) gReadCache.fileReadCalls += readCalls->GetVal();
+            TParameter<Long64_t>* checked = nullptr, *mismatches = nullptr;
+            io->GetObject("checkedBlips", checked);
+            io->GetObject("blipMismatches", mismatches);
+            if (checked) gBlipKernelCheck.nblips += checked->GetVal();
+            if (mismatches) gBlipKernelCheck.nmismatch += mismatches->GetVal();
+            TParameter<Long64_t>* accepted = nullptr;
+            io->GetObject("accepted", accepted);
+            if (accepted) gEventRange.accepted += accepted->GetVal();
+            if (gIOReport.enabled) MergeIOStats(io);
+            if (gReadCache.enabled()) MergeCacheStats(io, inputs.size());
+            TTree* shardSkim = skim ? shard->Get<TTree>(kSkimTree) : nullptr;
+            if (shardSkim) skim->CopyEntries(shardSkim);
+            shard->Close();
+        } else if (ok) {
+            std::cerr << "ERROR: cannot open worker shard " << shardFile << "\n";
+            ok = false;
+        }
+        gSystem->Unlink(shardFile.c_str());
+    }
 
+    return ok;
+}
 
-                                    WC_N_rec_protons = Get_Nproton(numu_cc_flag , kine_energy_particle,  kine_particle_type) ; 
-			                        //std::cout<<"Signal Event: R/S/E: "<<run<<"/"<<subrun<<"/"<<event<< std::endl; 
-                                    //std::cout<<"With:"<< Get_Nproton(numu_cc_flag , kine_energy_particle,  kine_particle_type)<<" reconstructed protons"<< std::endl;  
 
-                                    N_rec_protons = AddBacktrackedBlips ? WC_N_rec_protons + n_sig_all_regB_blips  : WC_N_rec_protons;
-				    
-                                                                          
 
-                                    h_1gX_Nprotons->Fill( N_rec_protons); 
+// --engine rdf: the same selection on one RDataFrame (rdf_engine.h). Every
+// histogram of every variant (and the skim snapshot) is booked first, so the
+// first GetPtr() runs a single event loop for all of them; the results are then
+// added into the (empty) histograms of each pass, which Finish() writes as usual.
+bool RunRDataFrameEngine(const std::vector<std::string>& files, bool isSkim,
+                         std::vector<std::unique_ptr<SelectionPass>>& passes,
+                         int nThreads, const std::string& skimFile) {
+
+    if (nThreads > 1) ROOT::EnableImplicitMT(nThreads);
+
+    // Entry range in the data source, then the prescale (event_range.h)
+    std::unique_ptr<ROOT::RDataFrame> df = MakeDataFrame(files, isSkim, gEventRange.begin, gEventRange.end);
+    double prescale = gEventRange.prescale;
+    ROOT::RDF::RNode entries = *df;
+    if (prescale < 1)
+        entries = entries.Filter([prescale](RDFColumn(run) r, RDFColumn(sub) s, RDFColumn(evt) e) {
+                                     return PassesPrescale(r, s, e, prescale);
+                                 }, {"run", "sub", "evt"});
+    ROOT::RDF::RResultPtr<ULong64_t> accepted = entries.Count();
+
+    // Events passing any variant, with the blips and EventSummary shared by all
+    std::vector<SelectionCuts> cutSets;
+    for (auto& pass : passes) cutSets.push_back(pass->variant.cuts);
+    ROOT::RDF::RNode events = DefineEventColumns(entries, cutSets, passes[0]->Radius);
+
+    // Skim: those events, added to the skim file next to T_pot
+    ROOT::RDF::RSnapshotOptions snapshotOptions;
+    snapshotOptions.fMode = "UPDATE";
+    snapshotOptions.fLazy = true;
+    decltype(events.Snapshot(kSkimTree, skimFile, SkimBranches(), snapshotOptions)) snapshot;
+    if (!skimFile.empty()) snapshot = events.Snapshot(kSkimTree, skimFile, SkimBranches(), snapshotOptions);
+
+    struct Booked {
+        std::vector<std::pair<TH1*, ROOT::RDF::RResultPtr<TH1D>>> h1;
+        std::vector<std::pair<TH1*, ROOT::RDF::RResultPtr<TH2D>>> h2;
+        ROOT::RDF::RResultPtr<ULong64_t> nSelected;
+        std::vector<ROOT::RDF::RResultPtr<ULong64_t>> noSigNorBkg;   // all, 0n, Nn
+    };
+    std::vector<Booked> booked(passes.size());
+
+    for (size_t iVar = 0; iVar < passes.size(); ++iVar) {
+        SelectionPass& pass = *passes[iVar];
+        Booked& b = booked[iVar];
+        std::string tag = "_" + std::to_string(iVar);
+
+        // RDataFrame model with the name, title and binning of a pass histogram
+        auto book1D = [&](ROOT::RDF::RNode node, int index, const std::string& column, auto type) {
+            TH1* h = pass.hists[index];
+            ROOT::RDF::TH1DModel model(h->GetName(), h->GetTitle(), h->GetNbinsX(),
+                                       h->GetXaxis()->GetXmin(), h->GetXaxis()->GetXmax());
+            b.h1.emplace_back(h, node.Histo1D<decltype(type)>(model, column));
+        };
+        auto book2D = [&](ROOT::RDF::RNode node, int index) {
+            TH1* h = pass.hists[index];
+            ROOT::RDF::TH2DModel model(h->GetName(), h->GetTitle(),
+                                       h->GetNbinsX(), h->GetXaxis()->GetXmin(), h->GetXaxis()->GetXmax(),
+                                       h->GetNbinsY(), h->GetYaxis()->GetXmin(), h->GetYaxis()->GetXmax());
+            b.h2.emplace_back(h, node.Histo2D<int, float>(model, "rdf_n_sig_all_blips", "rdf_SumE_sig_all_blips"));
+        };
+
+        ROOT::RDF::RNode sel = DefineSelectionColumns(events, pass.variant, tag);
+        b.nSelected = sel.Count();
+
+        // Blip populations
+        for (int iGroup = 0; iGroup < kNBlipGroups; ++iGroup) {
+            std::string group = "rdf_blipgroup" + std::to_string(iGroup) + "_";
+            for (int var = 0; var < kNBlipVars; ++var) {
+                std::string column = group + kBlipVars[var];
+                if (var == kBlipEnergy || var == kBlipDist2vtx)
+                    book1D(sel, BlipHist(iGroup, var), column, ROOT::RVec<float>());
+                else
+                    book1D(sel, BlipHist(iGroup, var), column, ROOT::RVec<double>());
+            }
+        }
+
+        // Number of protons, split by truth category, for all/0n/Nn
+        ROOT::RDF::RNode zeroN = sel.Filter([](bool is_0n) { return is_0n; }, {"rdf_is_0n"});
+        ROOT::RDF::RNode manyN = sel.Filter([](bool is_0n) { return !is_0n; }, {"rdf_is_0n"});
+        std::vector<std::pair<int, ROOT::RDF::RNode>> splits = { {kSplitAll, sel}, {kSplit0n, zeroN}, {kSplitNn, manyN} };
+        for (auto& split : splits) {
+            book1D(split.second, NprotonsHist(split.first), "rdf_N_rec_protons" + tag, int());
+            for (int category = 0; category < kNSPCategories; ++category) {
+                ROOT::RDF::RNode node = split.second.Filter([category](int c) { return c == category; }, {"rdf_sp_category"});
+                book1D(node, SPHist(category, split.first), "rdf_N_rec_protons" + tag, int());
+            }
+            b.noSigNorBkg.push_back(split.second.Filter([](int c) { return c < 0; }, {"rdf_sp_category"}).Count());
+        }
+
+        // Blip multiplicity and summed energy, for all/0p/Np
+        ROOT::RDF::RNode zeroP = sel.Filter([](bool is0p) { return is0p; }, {"rdf_is_0p"});
+        ROOT::RDF::RNode manyP = sel.Filter([](bool is0p) { return !is0p; }, {"rdf_is_0p"});
+        std::vector<std::pair<int, ROOT::RDF::RNode>> protonSplits = { {kSplitAll, sel}, {kSplit0p, zeroP}, {kSplitNp, manyP} };
+        for (auto& split : protonSplits) {
+            book1D(split.second, BlipMultiplicityHist(split.first), "rdf_n_sig_all_blips", int());
+            book1D(split.second, SumEblipHist(split.first), "rdf_SumE_sig_all_blips", float());
+            book2D(split.second, MultiplicitySumEHist(split.first));
+        }
+    }
 
-                                    // breakdown categories for single photon analysis
-                                    if (match_completeness_energy>0.1*truth_energyInside && truth_single_photon==1 && truth_isCC==0 && truth_NCDelta==1 && truth_vtxInside==1) h_SPNCDeltaSig_Nprotons->Fill(N_rec_protons) ;
-                                    else if (match_completeness_energy>0.1*truth_energyInside && truth_single_photon==1 && truth_isCC==0 && (truth_showerMother==111) && truth_vtxInside==1) h_SPNCPi0Sig_Nprotons->Fill(N_rec_protons) ;
-                                    else if (match_completeness_energy>0.1*truth_energyInside && truth_single_photon==1 && truth_isCC==0 && truth_showerMother!=111 && truth_NCDelta==0 && truth_vtxInside==1)  h_SPNCOtherSig_Nprotons->Fill(N_rec_protons) ;
-                                    else if (match_completeness_energy>0.1*truth_energyInside && truth_single_photon==1 && truth_isCC==1 && abs(truth_nuPdg)==14 && truth_muonMomentum[3]-0.105658<0.1 && truth_vtxInside==1)  h_SPNumuCCSig_Nprotons->Fill(N_rec_protons) ;
-                                    else if (match_completeness_energy>0.1*truth_energyInside && truth_single_photon==1 && (truth_isCC==0 || (truth_isCC==1 && abs(truth_nuPdg)==14 && truth_muonMomentum[3]-0.105658<0.1)) && truth_vtxInside==0)  h_SPOutFVSig_Nprotons->Fill(N_rec_protons) ;
-                                    else if (match_completeness_energy>0.1*truth_energyInside && truth_single_photon==1 && truth_isCC==0 ) h_SPNumuCCSigGen_Nprotons->Fill(N_rec_protons) ;
+    // --- Event loop (runs on the first result accessed) ---
+    for (size_t iVar = 0; iVar < passes.size(); ++iVar) {
+        SelectionPass& pass = *passes[iVar];
+        Booked& b = booked[iVar];
+        for (auto& h : b.h1) h.first->Add(h.second.GetPtr());
+        for (auto& h : b.h2) h.first->Add(h.second.GetPtr());
+        pass.signal_events = *b.nSelected;
+        pass.NoSigNorBkg[kSplitAll] = *b.noSigNorBkg[0];
+        pass.NoSigNorBkg[kSplit0n]  = *b.noSigNorBkg[1];
+        pass.NoSigNorBkg[kSplitNn]  = *b.noSigNorBkg[2];
+    }
+    gEventRange.accepted = *accepted;
+    return true;
+}
 
 
-                                    // Background categories
-                                    else if(match_completeness_energy>0.1*truth_energyInside && truth_vtxInside==0) h_SPoutFVBkg_Nprotons->Fill(N_rec_protons) ;
-                                    else if(match_completeness_energy>0.1*truth_energyInside && abs(truth_nuPdg)==14 && truth_isCC==1 && truth_vtxInside==1 && truth_Npi0==0) h_SPnumuCCBkg_Nprotons->Fill(N_rec_protons) ;
-                                    else if(match_completeness_energy>0.1*truth_energyInside && abs(truth_nuPdg)==14 && truth_isCC==1 && truth_vtxInside==1 && truth_Npi0>0) h_SPnumuCCpi0Bkg_Nprotons->Fill(N_rec_protons) ;
-                                    else if(match_completeness_energy>0.1*truth_energyInside && abs(truth_nuPdg)==12 && truth_isCC==1 && truth_vtxInside==1 ) h_SPnueCCBkg_Nprotons->Fill(N_rec_protons) ;
-                                    else if(match_completeness_energy>0.1*truth_energyInside && truth_isCC==0 && truth_vtxInside==1 && truth_Npi0==0)  h_SPNCBkg_Nprotons->Fill(N_rec_protons) ;
-                                    else if(match_completeness_energy>0.1*truth_energyInside && truth_isCC==0 && truth_vtxInside==1 && truth_Npi0>0) h_SPNCpi0Bkg_Nprotons->Fill(N_rec_protons) ;
-                                    else if (match_completeness_energy<=0.1*truth_energyInside ) h_CosmicBkg_Nprotons->Fill(N_rec_protons) ; //bad match
-                                    else NoSigNorBkg++; 
 
+// Everything besides the input events that the content of an output file
+// depends on. merge_shards only adds files with the same configuration.
+std::string SelectionConfig(const SelectionPass& pass, bool IsData) {
+    const SelectionCuts& cuts = pass.variant.cuts;
+    std::ostringstream config;
+    config << "label=" << pass.variant.label << "\n"
+           << "IsData=" << IsData << "\n"
+           << "cuts=" << DescribeCuts(cuts) << "\n"
+           << "AddBacktrackedBlips=" << pass.variant.AddBacktrackedBlips << "\n"
+           << "Radius=" << pass.Radius << "\n"
+           << "prescale=" << gEventRange.prescale << "\n"
+           << "cutflow=" << gCutFlow.enabled << "\n"
+           << "radius_scan=";
+    for (float radius : gRadiusScan.radii) config << radius << ",";
+    config << "\nbdt_scan=";
+    if (gBDTScan.enabled)
+        for (int d = 0; d < kNScanDims; ++d) {
+            config << kScanDimNames[d] << ":";
+            for (double value : gBDTScan.values[d]) config << value << ",";
+            config << ";";
+        }
+    config << "\n";
+    return config.str();
+}
 
 
 
+int main(int argc, char** argv) {
 
+    // Positional arguments and --variant options
+    std::vector<std::string> positional;
+    std::vector<std::string> variantSpecs;
+    bool UseBranchManifest = true;
+    int nThreads = 1;
+    std::string engine = "loop";
+    std::string skimFile;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--variant" && i + 1 < argc) variantSpecs.push_back(argv[++i]);
+        else if (arg == "--all-branches") UseBranchManifest = false;
+        else if (arg == "--threads" && i + 1 < argc) nThreads = std::max(1, atoi(argv[++i]));
+        else if (arg == "--engine" && i + 1 < argc) engine = argv[++i];
+        else if (arg == "--skim" && i + 1 < argc) skimFile = argv[++i];
+        else if (arg == "--check-blip-kernel") gBlipKernelCheck.enabled = true;
+        else if (arg == "--cutflow") gCutFlow.enabled = true;
+        else if (arg == "--io-report") gIOReport.enabled = true;
+        else if (arg == "--cache" && i + 1 < argc) {
+            if (!ParseCacheSize(argv[++i], gReadCache.bytes)) return 1;
+        }
+        else if (arg == "--prefetch") gReadCache.prefetch = true;
+        else if (arg == "--hist-bundle") gWriteHistBundle = true;
+        else if (arg == "--index-dir" && i + 1 < argc) gEventIndexDir = argv[++i];
+        else if (arg == "--stage-dir" && i + 1 < argc) gStage.dir = argv[++i];
+        else if (arg == "--stage-limit" && i + 1 < argc) {
+            if (!ParseStageLimit(argv[++i], gStage.limitBytes)) return 1;
+        }
+        else if (arg == "--bdt-scan" && i + 1 < argc) {
+            if (!ParseBDTScan(argv[++i], gBDTScan)) return 1;
+        }
+        else if (arg == "--radius-scan" && i + 1 < argc) {
+            if (!ParseScanRadii(argv[++i], gRadiusScan.radii)) return 1;
+        }
+        else if (arg == "--first" && i + 1 < argc) {
+            if (!ParseEntryNumber(argv[++i], "--first", gEventRange.first)) return 1;
+        }
+        else if (arg == "--count" && i + 1 < argc) {
+            if (!ParseEntryNumber(argv[++i], "--count", gEventRange.count)) return 1;
+        }
+        else if (arg == "--shard" && i + 1 < argc) {
+            if (!ParseShard(argv[++i], gEventRange)) return 1;
+        }
+        else if (arg == "--prescale" && i + 1 < argc) {
+            if (!ParsePrescale(argv[++i], gEventRange.prescale)) return 1;
+        }
+        else positional.push_back(arg);
+    }
 
-				//0n/Nn designations
-				    if(n_sig_all_blips < 10 &&  SumE_sig_all_blips <= 8 ){ //0n
-                                    h_1gX_Nprotons_0n->Fill( N_rec_protons);
+    bool singlePass = !variantSpecs.empty();
 
-                                    // breakdown categories for single photon analysis
-                                    if (match_completeness_energy>0.1*truth_energyInside && truth_single_photon==1 && truth_isCC==0 && truth_NCDelta==1 && truth_vtxInside==1) h_SPNCDeltaSig_Nprotons_0n->Fill(N_rec_protons) ;
-                                    else if (match_completeness_energy>0.1*truth_energyInside && truth_single_photon==1 && truth_isCC==0 && (truth_showerMother==111) && truth_vtxInside==1) h_SPNCPi0Sig_Nprotons_0n->Fill(N_rec_protons) ;
-                                    else if (match_completeness_energy>0.1*truth_energyInside && truth_single_photon==1 && truth_isCC==0 && truth_showerMother!=111 && truth_NCDelta==0 && truth_vtxInside==1)  h_SPNCOtherSig_Nprotons_0n->Fill(N_rec_protons) ;
-                                    else if (match_completeness_energy>0.1*truth_energyInside && truth_single_photon==1 && truth_isCC==1 && abs(truth_nuPdg)==14 && truth_muonMomentum[3]-0.105658<0.1 && truth_vtxInside==1)  h_SPNumuCCSig_Nprotons_0n->Fill(N_rec_protons) ;
-                                    else if (match_completeness_energy>0.1*truth_energyInside && truth_single_photon==1 && (truth_isCC==0 || (truth_isCC==1 && abs(truth_nuPdg)==14 && truth_muonMomentum[3]-0.105658<0.1)) && truth_vtxInside==0)  h_SPOutFVSig_Nprotons_0n->Fill(N_rec_protons) ;
-                                    else if (match_completeness_energy>0.1*truth_energyInside && truth_single_photon==1 && truth_isCC==0 ) h_SPNumuCCSigGen_Nprotons_0n->Fill(N_rec_protons) ;
+    if (engine != "loop" && engine != "rdf") {
+        std::cerr << "ERROR: Unknown --engine '" << engine << "'. Expected loop or rdf.\n";
+        return 1;
+    }
+    if (engine == "rdf" && gCutFlow.enabled) {
+        std::cerr << "WARNING: --cutflow is only implemented for the event loop engine, ignored with --engine rdf\n";
+        gCutFlow.enabled = false;
+    }
+    if (engine == "rdf" && gIOReport.enabled) {
+        std::cerr << "WARNING: --io-report is only implemented for the event loop engine, ignored with --engine rdf\n";
+        gIOReport.enabled = false;
+    }
+    if (engine == "rdf" && (gReadCache.bytes >= 0 || gReadCache.prefetch)) {
+        std::cerr << "WARNING: --cache and --prefetch are only implemented for the event loop engine "
+                  << "(RDataFrame sets up its own TTreeCache), ignored with --engine rdf\n";
+        gReadCache = ReadCacheSettings();
+    }
+    if (gReadCache.prefetch && gReadCache.bytes == 0) {
+        std::cerr << "WARNING: --prefetch needs a cache, ignored with --cache 0\n";
+        gReadCache.prefetch = false;
+    }
+    if (gReadCache.prefetch && gReadCache.bytes < 0) gReadCache.bytes = kDefaultCacheMB * 1024 * 1024;
+    if (engine == "rdf" && !gRadiusScan.radii.empty()) {
+        std::cerr << "WARNING: --radius-scan is only implemented for the event loop engine, ignored with --engine rdf\n";
+        gRadiusScan.radii.clear();
+    }
+    if (engine == "rdf" && gBDTScan.enabled) {
+        std::cerr << "WARNING: --bdt-scan is only implemented for the event loop engine, ignored with --engine rdf\n";
+        gBDTScan.enabled = false;
+    }
 
+    if ((!singlePass && positional.size() < 5) || (singlePass && positional.size() < 2)) {
+        std::cerr << "Usage:\n"
+                  << argv[0] 
+                  << " <inputFile.root|'glob*.root'|files.list> <label> <bool1> <bool2> <outputDir>\n"
+                  << argv[0]
+                  << " <inputFile.root|'glob*.root'|files.list> <IsData> --variant <label>,<AddBacktrkBlips>,<outputDir> [--variant ...]\n"
+                  << "Options:\n"
+                  << "  --all-branches   read every branch instead of only the ones in branch_manifest.h\n"
+                  << "  --threads N      run N worker processes (one file or entry range each) and merge their histograms\n"
+                  << "  --engine rdf     run the selection on RDataFrame (implicit MT with --threads) instead of the event loop\n"
+                  << "  --skim FILE      also write the preselected events (manifest branches only) to FILE;\n"
+                  << "                   FILE can be used as <inputFile.root> afterwards\n"
+                  << "  --check-blip-kernel  compare the blip kernel with the common_funtions.h helpers for every blip\n"
+                  << "  --cutflow        count the events/blips after each preselection/blip cut and time the loop stages\n"
+                  << "                   (h_cutflow_* histograms and <outputFile>.cutflow.json)\n"
+                  << "  --io-report      TTreePerfStats and read time per input tree, real/CPU time and events/s\n"
+                  << "                   (printed and written to <outputFile>.io.json)\n"
+                  << "  --cache MB       TTreeCache of MB per input tree with only the preselection branches, no learning\n"
+                  << "                   phase (0: no cache); prints the hit rate per tree and the file read calls\n"
+                  << "  --prefetch       asynchronous prefetching of the next cache block (default cache 30 MB)\n"
+                  << "  --hist-bundle    also write the histograms to <outputFile>.hbundle, a flat file the plotting\n"
+                  << "                   can mmap instead of reading the ROOT file (see hist_bundle.h)\n"
+                  << "  --index-dir DIR  cache of the event indices of non-aligned inputs (default evtindex)\n"
+                  << "  --stage-dir DIR  read local copies of the input files, staged in DIR (see stage_cache.h)\n"
+                  << "  --stage-limit GB size limit of DIR, least recently used files are deleted first (default 100)\n"
+                  << "  --radius-scan R1,R2,...  also histogram protons (all/0n/Nn), blip multiplicity and energy\n"
+                  << "                   for each sphere radius [cm], in radius_scan/R<radius>/ of the output file\n"
+                  << "  --bdt-scan SPEC  yields per truth category and N protons for a grid of BDT thresholds, e.g.\n"
+                  << "                   'numu=0.1:0.5:0.1;other=-0.4,0,0.2;br1=0,1' (bdt_scan tree, see bdt_scan.h)\n"
+                  << "  --first N, --count N  only run the entries [N, N + count) of the input chain\n"
+                  << "  --shard i/N      run the i-th of N contiguous chunks of the entries (i = 0..N-1)\n"
+                  << "  --prescale F     keep the fraction F of the events, by a hash of (run, subrun, event)\n"
+                  << "                   (default 0.5 for data, 1 for MC; see event_range.h)\n";
+        std::cerr << "Example:\n"
+                  << argv[0] 
+                  << " data.root MyTag 1 0 Results\n"
+                  << argv[0]
+                  << " data.root 0 --variant Signal,0,SIGNAL --variant SignalBTB,1,SIGNAL_BTB --variant Sideband,0,SIDEBAND\n";
+        return 1;
+    }
 
-                                    // Background categories
-                                    else if(match_completeness_energy>0.1*truth_energyInside && truth_vtxInside==0) h_SPoutFVBkg_Nprotons_0n->Fill(N_rec_protons) ;
-                                    else if(match_completeness_energy>0.1*truth_energyInside && abs(truth_nuPdg)==14 && truth_isCC==1 && truth_vtxInside==1 && truth_Npi0==0) h_SPnumuCCBkg_Nprotons_0n->Fill(N_rec_protons) ;
-                                    else if(match_completeness_energy>0.1*truth_energyInside && abs(truth_nuPdg)==14 && truth_isCC==1 && truth_vtxInside==1 && truth_Npi0>0) h_SPnumuCCpi0Bkg_Nprotons_0n->Fill(N_rec_protons) ;
-                                    else if(match_completeness_energy>0.1*truth_energyInside && abs(truth_nuPdg)==12 && truth_isCC==1 && truth_vtxInside==1 ) h_SPnueCCBkg_Nprotons_0n->Fill(N_rec_protons) ;
-                                    else if(match_completeness_energy>0.1*truth_energyInside && truth_isCC==0 && truth_vtxInside==1 && truth_Npi0==0)  h_SPNCBkg_Nprotons_0n->Fill(N_rec_protons) ;
-                                    else if(match_completeness_energy>0.1*truth_energyInside && truth_isCC==0 && truth_vtxInside==1 && truth_Npi0>0) h_SPNCpi0Bkg_Nprotons_0n->Fill(N_rec_protons) ;
-                                    else if (match_completeness_energy<=0.1*truth_energyInside ) h_CosmicBkg_Nprotons_0n->Fill(N_rec_protons) ; //bad match
-                                    else NoSigNorBkg0n++;	
+    std::string inputFile = positional[0];
+    std::vector<std::string> inputFiles = ExpandInputFiles(inputFile);
+    if (inputFiles.empty()) return 1;
+    if (gStage.enabled()) inputFiles = StageInputFiles(inputFiles);
+    bool IsData           = ParseBool(singlePass ? positional[1] : positional[2]);
+
+    // --- Selection variants ---
+    // Legacy form: <inputFile.root> <label> <IsData> <AddBacktrkBlips> <outputDir>
+    // Single-pass form: <inputFile.root> <IsData> --variant <label>,<AddBacktrkBlips>,<outputDir> [--variant ...]
+    std::vector<SelectionVariant> variants;
+    if (singlePass) {
+        for (const std::string& spec : variantSpecs) {
+            SelectionVariant variant;
+            if (!ParseVariantSpec(spec, variant, ParseBool)) return 1;
+            variants.push_back(variant);
+        }
+    } else {
+        SelectionVariant variant;
+        variant.label = positional[1];
+        variant.AddBacktrackedBlips = ParseBool(positional[3]);
+        variant.outDir = positional[4];
+        if (!CutsForLabel(variant.label, variant.cuts)) return 1;
+        variants.push_back(variant);
+    }
 
-				   }else{ //Nn
+    // Base filename (input file name without extension)
+    std::string baseName  = InputBaseName(inputFile);
 
-                                   h_1gX_Nprotons_Nn->Fill( N_rec_protons);
+    std::cout << " ---- SETTINGS ----\n";
+    std::cout << " Input ROOT File : " << inputFile << "\n";
+    if (inputFiles.size() > 1)
+        std::cout << " Input files     : " << inputFiles.size() << " (chained)\n";
+    std::cout << " IsData          : " << (IsData ? "true" : "false") << "\n";
+    std::cout << " Engine          : " << engine << "\n";
 
-                                    // breakdown categories for single photon analysis
-                                    if (match_completeness_energy>0.1*truth_energyInside && truth_single_photon==1 && truth_isCC==0 && truth_NCDelta==1 && truth_vtxInside==1) h_SPNCDeltaSig_Nprotons_Nn->Fill(N_rec_protons) ;
-                                    else if (match_completeness_energy>0.1*truth_energyInside && truth_single_photon==1 && truth_isCC==0 && (truth_showerMother==111) && truth_vtxInside==1) h_SPNCPi0Sig_Nprotons_Nn->Fill(N_rec_protons) ;
-                                    else if (match_completeness_energy>0.1*truth_energyInside && truth_single_photon==1 && truth_isCC==0 && truth_showerMother!=111 && truth_NCDelta==0 && truth_vtxInside==1)  h_SPNCOtherSig_Nprotons_Nn->Fill(N_rec_protons) ;
-                                    else if (match_completeness_energy>0.1*truth_energyInside && truth_single_photon==1 && truth_isCC==1 && abs(truth_nuPdg)==14 && truth_muonMomentum[3]-0.105658<0.1 && truth_vtxInside==1)  h_SPNumuCCSig_Nprotons_Nn->Fill(N_rec_protons) ;
-                                    else if (match_completeness_energy>0.1*truth_energyInside && truth_single_photon==1 && (truth_isCC==0 || (truth_isCC==1 && abs(truth_nuPdg)==14 && truth_muonMomentum[3]-0.105658<0.1)) && truth_vtxInside==0)  h_SPOutFVSig_Nprotons_Nn->Fill(N_rec_protons) ;
-                                    else if (match_completeness_energy>0.1*truth_energyInside && truth_single_photon==1 && truth_isCC==0 ) h_SPNumuCCSigGen_Nprotons_Nn->Fill(N_rec_protons) ;
+    std::vector<std::string> outputFiles;
+    for (const SelectionVariant& variant : variants) {
 
+        // Create output directory if missing
+        if (gSystem->AccessPathName(variant.outDir.c_str())) {
+            std::cout << "Directory does not exist. Creating: " << variant.outDir << std::endl;
+            gSystem->mkdir(variant.outDir.c_str(), true);
+        }
 
-                                    // Background categories
-                                    else if(match_completeness_energy>0.1*truth_energyInside && truth_vtxInside==0) h_SPoutFVBkg_Nprotons_Nn->Fill(N_rec_protons) ;
-                                    else if(match_completeness_energy>0.1*truth_energyInside && abs(truth_nuPdg)==14 && truth_isCC==1 && truth_vtxInside==1 && truth_Npi0==0) h_SPnumuCCBkg_Nprotons_Nn->Fill(N_rec_protons) ;
-                                    else if(match_completeness_energy>0.1*truth_energyInside && abs(truth_nuPdg)==14 && truth_isCC==1 && truth_vtxInside==1 && truth_Npi0>0) h_SPnumuCCpi0Bkg_Nprotons_Nn->Fill(N_rec_protons) ;
-                                    else if(match_completeness_energy>0.1*truth_energyInside && abs(truth_nuPdg)==12 && truth_isCC==1 && truth_vtxInside==1 ) h_SPnueCCBkg_Nprotons_Nn->Fill(N_rec_protons) ;
-                                    else if(match_completeness_energy>0.1*truth_energyInside && truth_isCC==0 && truth_vtxInside==1 && truth_Npi0==0)  h_SPNCBkg_Nprotons_Nn->Fill(N_rec_protons) ;
-                                    else if(match_completeness_energy>0.1*truth_energyInside && truth_isCC==0 && truth_vtxInside==1 && truth_Npi0>0) h_SPNCpi0Bkg_Nprotons_Nn->Fill(N_rec_protons) ;
-                                    else if (match_completeness_energy<=0.1*truth_energyInside ) h_CosmicBkg_Nprotons_Nn->Fill(N_rec_protons) ; //bad match
-                                    else NoSigNorBkgNn++;
+        // Start forming output filename
+        std::string outputName = baseName + "_" + variant.label;
 
-			            }
+        // Append flags if true (customize text below if desired)
+        if (IsData) outputName += "_Data";
+        if (variant.AddBacktrackedBlips) outputName += "_BacktrkBlips";
 
+        // Add ROOT extension and path
+        outputFiles.push_back(variant.outDir + "/" + outputName + ".root");
 
+        std::cout << " Signal/Sideband : " << variant.label << " (" << variant.cuts.name << " cuts)\n";
+        std::cout << " AddBackTrkBlips : " << (variant.AddBacktrackedBlips ? "true" : "false") << "\n";
+        std::cout << " Output File     : " << outputFiles.back() << "\n";
+    }
+    std::cout << " ------------------\n";
 
+    // Open input file
+    // A skim only has the manifest branches, so --all-branches does not apply
+    bool skimInput = IsSkimFile(inputFiles[0]);
+    if (skimInput && !UseBranchManifest) {
+        std::cout << "Input is a skim: ignoring --all-branches\n";
+        UseBranchManifest = true;
+    }
+    InputSet input;
+    if (gReadCache.prefetch) EnableAsyncPrefetching();
+    if (!OpenInput(inputFiles, UseBranchManifest, input) || !AlignInput(input)) return 1;
+    std::vector<SelectionCuts> cutSets;
+    for (const SelectionVariant& variant : variants) cutSets.push_back(variant.cuts);
+    if (skimInput && !CheckSkimSelection(inputFiles, cutSets, gBDTScan.enabled)) return 1;
+    TTree* fTree = input.trees[0].tree;
+    long npayload = 0;
+    Long64_t fileBytesRead = 0;
 
-                                    //----------------------
-                                    // --- 0p/Np split ---
-                                    //----------------------
-                                    h_1gX_BlipMultiplicity->Fill(n_sig_all_blips);
-                                    h_1gX_SumEblip->Fill(SumE_sig_all_blips); 
-			            h2D_1gX_BlipMultiplicity_SumEblip->Fill(n_sig_all_blips, SumE_sig_all_blips);
+    if (!skimFile.empty() && !CreateSkimFile(skimFile, input.chains.back())) return 1;
 
 
-                                    if (is_0p(numu_cc_flag , kine_energy_particle,  kine_particle_type) == true) {
-                                     // 0p-dataset 
-                                     
-                                        h_1gX_BlipMultiplicity_0p->Fill(n_sig_all_blips);
-                                        h_1gX_SumEblip_0p->Fill(SumE_sig_all_blips);
-					h2D_1gX_BlipMultiplicity_SumEblip_0p->Fill(n_sig_all_blips, SumE_sig_all_blips);
-					
-					                                    
-                                    }else{ //Np-dataset
-                                        h_1gX_BlipMultiplicity_Np->Fill(n_sig_all_blips);
-                                        h_1gX_SumEblip_Np->Fill(SumE_sig_all_blips); 
-					h2D_1gX_BlipMultiplicity_SumEblip_Np->Fill(n_sig_all_blips, SumE_sig_all_blips);
+    // Create one output ROOT file + histogram set per variant
+    std::vector<std::unique_ptr<SelectionPass>> passes;
+    for (size_t iVar = 0; iVar < variants.size(); ++iVar)
+        passes.emplace_back(new SelectionPass(variants[iVar], outputFiles[iVar]));
 
-	                                 }
 
+    // --- Event loop ---
+    // Entries [--first, --first + --count), the --shard of them this job runs,
+    // and the prescale (half of the data events by default), see event_range.h
+    gEventRange.input = inputFile;
+    ResolveEventRange(fTree->GetEntries(), IsData, skimInput, gEventRange);
+    for (auto& pass : passes) pass->config = SelectionConfig(*pass, IsData);
+    long nevents = gEventRange.end - gEventRange.begin;
+
+    // A skim already holds only the selected part of its input: quote the
+    // input entry count in the signal/total print-out
+    if (skimInput && !gEventRange.IsDefault())
+        std::cerr << "WARNING: the signal/total print-out of a skim counts all the events the skim was made from, "
+                  << "not only those of --first/--count/--shard/--prescale\n";
+    std::cout << "fTree->GetEntries() " << fTree->GetEntries() << std::endl;
+    std::cout << "Entries [" << gEventRange.begin << ", " << gEventRange.end << ")";
+    if (gEventRange.nShards > 1) std::cout << ", shard " << gEventRange.shard << "/" << gEventRange.nShards;
+    std::cout << ", prescale " << gEventRange.prescale << std::endl;
+    std::cout << "Total events: " << nevents << std::endl;
 
-                                        if( Get_Nproton(numu_cc_flag , kine_energy_particle,  kine_particle_type)== 0 && backtracked_blip > 0 )WC_0p_wBB++ ; 
-                                        if( Get_Nproton(numu_cc_flag , kine_energy_particle,  kine_particle_type) > 0 && backtracked_blip > 0 )WC_Np_wBB++ ; 
-	                                    backtracked_blip = 0 ; 
+    // Skim tree of the event loop engine (the RDataFrame engine uses a snapshot)
+    TFile* skimOut = nullptr;
+    TTree* skim = nullptr;
+    if (!skimFile.empty() && engine == "loop") {
+        skimOut = new TFile(skimFile.c_str(), "UPDATE");
+        skim = CreateSkimTree(input.trees);
+    }
 
+    if (engine == "rdf") {
+        // The friend trees of the data frame are read by entry number
+        for (const InputTree& in : input.trees)
+            if (!in.entryMap.empty()) {
+                std::cerr << "ERROR: " << in.path << " is not entry-aligned with the PeLEE tree; "
+                          << "--engine rdf needs aligned trees, use --engine loop\n";
+                return 1;
+            }
+        if (!RunRDataFrameEngine(inputFiles, input.isSkim, passes, nThreads, skimFile)) return 1;
+    } else if (nThreads > 1) {
+        if (gIOReport.enabled) StartIOReport(input.trees, false);   // the workers read the trees
+        std::vector<WorkUnit> units = MakeWorkUnits(input, nThreads, gEventRange.begin, gEventRange.end);
+        if (!RunParallel(nThreads, units, UseBranchManifest, passes, input.trees, npayload, fileBytesRead, skim)) return 1;
+    } else {
+        SetUpReadCache(input.trees, UseBranchManifest, gEventRange.begin, gEventRange.end);
+        if (gIOReport.enabled) StartIOReport(input.trees, true);
+        npayload = RunEventLoop(input.trees, passes, UseBranchManifest, gEventRange.begin, gEventRange.end, skim);
+        CollectCacheStats(input.trees);
+    }
+    if (gIOReport.enabled) StopIOReport(input.trees);
+    long sourceEvents = skimInput ? ReadSkimSourceEntries(inputFiles) : gEventRange.accepted;
+
+    if (!skimFile.empty()) {
+        if (!skimOut) skimOut = new TFile(skimFile.c_str(), "UPDATE");
+        skimOut->cd();
+        if (skim) skim->Write();
+        WriteSkimSourceEntries(skimOut, sourceEvents);
+        WriteSkimSelection(skimOut, cutSets, gBDTScan.enabled);
+        WriteEventRange(skimOut, gEventRange);
+        std::cout << "Skim written to " << skimFile << std::endl;
+        skimOut->Close();
+    }
 
-                                }// Signal Events
-                            
-                            
-                            
-                            }//<--End Event Loop
 
+    FlushCutFlows(passes);
+    FlushBDTScan(passes);
+    for (auto& pass : passes) {
+        std::cout << "\n ==== " << pass->variant.label << " ====" << std::endl;
+        pass->Finish(sourceEvents);
+    }
 
+    fileBytesRead += TFile::GetFileBytesRead();
+    gReadCache.fileReadCalls += TFile::GetFileReadCalls();
+    if (engine == "rdf")
+        std::cout << "\n Total bytes read from file (compressed): " << fileBytesRead << "\n";
+    else
+        PrintReadSummary(input.trees, fileBytesRead, UseBranchManifest, nevents, npayload);
+
+    if (gIOReport.enabled) {
+        PrintIOReport(input.trees, nevents);
+        for (const std::string& outputFile : outputFiles) {
+            std::string json = outputFile.substr(0, outputFile.size() - 5) + ".io.json";
+            if (WriteIOReport(json, inputFile, input.trees, nevents, npayload, fileBytesRead, nThreads))
+                std::cout << "I/O report written to " << json << std::endl;
+        }
+    }
 
-    
-   Float_t a;
-   TTree tree("evd_tree", "TTree with a single float branch for number of signal events");
-   TBranch* branch = tree.Branch("total_signal_events", &a, "total_signal_events/F");
-   a = signal_events ; 
-   tree.Fill();
+    if (engine == "loop" && gReadCache.bytes >= 0) PrintCacheReport(input.trees);
 
+    if (gBlipKernelCheck.enabled)
+        std::cout << "\n Blip kernel check: " << gBlipKernelCheck.nmismatch << " mismatches in "
+                  << gBlipKernelCheck.nblips << " blips" << std::endl;
 
-    std::cout << "signal events/total events = "<< signal_events <<" / "<<nevents <<" = " << (float) signal_events / nevents<<std::endl; 
-    std::cout << "WC_0p_wBB: "<< WC_0p_wBB <<std::endl; 
-    std::cout << "WC_Np_wBB: "<< WC_Np_wBB <<std::endl;
-   
-/* 
-    std::cout <<"backtracked_blip_mc: "<< backtracked_blip_mc <<std::endl; 
-    std::cout <<"backtracked_blip_mc_proton: "<< backtracked_blip_mc_proton <<std::endl;
-    std::cout <<"backtracked_blip_mc_electron: "<< backtracked_blip_mc_electron <<std::endl;
-    std::cout <<"backtracked_blip_mc_heavyN: "<<backtracked_blip_mc_heavyN  <<std::endl;
-    std::cout <<"backtracked_blip_mc_othe: "<<backtracked_blip_mc_other  <<std::endl;
-    std::cout <<"backtracked_blip_overlay: "<< backtracked_blip_overlay  <<std::endl;
-*/
-    std::cout <<"\n"<<std::endl; 
-    std::cout<<" h_1gX_Nprotons :"<< h_1gX_Nprotons->GetEntries()<<std::endl; 
-    std::cout <<"Signal Categories\n"<<std::endl;
-    std::cout <<"h_SPNCDeltaSig_Nprotons :"<< h_SPNCDeltaSig_Nprotons->GetEntries()<<std::endl;
-    std::cout <<"h_SPNCPi0Sig_Nprotons   :"<< h_SPNCPi0Sig_Nprotons  ->GetEntries()<<std::endl; 
-    std::cout <<"h_SPNCOtherSig_Nprotons :"<< h_SPNCOtherSig_Nprotons->GetEntries()<<std::endl; 
-    std::cout <<"h_SPNumuCCSig_Nprotons  :"<< h_SPNumuCCSig_Nprotons ->GetEntries()<<std::endl;
-    std::cout <<"h_SPNumuCCSigGen_Nprotons  :"<< h_SPNumuCCSigGen_Nprotons ->GetEntries()<<std::endl;
-    std::cout <<"h_SPOutFVSig_Nprotons   :"<< h_SPOutFVSig_Nprotons  ->GetEntries()<<std::endl;
-    std::cout <<"Background Categories :"<<std::endl;
-    std::cout <<"h_SPoutFVBkg_Nprotons   :"<<h_SPoutFVBkg_Nprotons   ->GetEntries()<<std::endl;
-    std::cout <<"h_SPnumuCCBkg_Nprotons  :"<<h_SPnumuCCBkg_Nprotons  ->GetEntries()<<std::endl;
-    std::cout <<"h_SPnumuCCpi0Bkg_Nprotons:"<<h_SPnumuCCpi0Bkg_Nprotons->GetEntries()<<std::endl;
-    std::cout <<"h_SPnueCCBkg_Nprotons  :"<<h_SPnueCCBkg_Nprotons  ->GetEntries()<<std::endl;
-    std::cout <<"h_SPNCBkg_Nprotons       :"<<h_SPNCBkg_Nprotons     ->GetEntries()<<std::endl;
-    std::cout <<"h_SPNCpi0Bkg_Nprotons    :"<<h_SPNCpi0Bkg_Nprotons ->GetEntries()<<std::endl;
-    std::cout <<"h_CosmicBkg_Nprotons     :"<<h_CosmicBkg_Nprotons ->GetEntries()<<std::endl;
-    std::cout <<"No Signal nor Background:"<<NoSigNorBkg<<std::endl; 
-   
-//     std::cout << "Histograms saved to " << outputFile << std::endl;
-    fOutFile->Write();
-    fOutFile->Close();
-    fInputFile->Close();
+    CloseInput(input);
     return 0;
 
-
-
-
-
-
-
-
-
-
-
-
-
 }//<--End main
@@ -0,0 +1,313 @@
+// BDT threshold grid scan (--bdt-scan SPEC).
+//
+// The signal and sideband selections only differ in the four single photon
+// BDT score thresholds and the shw_sp_n_20br1_showers requirement
+// (selection_variants.h), so tuning them meant editing kSignalCuts and
+// rerunning. With --bdt-scan the event loop also keeps every event that
+// passes the score independent cuts (crtveto, Enu, 20 MeV showers, vertex X)
+// as a small BDTScanRecord: the scores, the 20br1 shower test, the truth
+// category and the proton counts.
+//
+// Each pass then turns the records into yields for every point of the
+// threshold grid without looping over the events per grid point. Along every
+// grid dimension the thresholds are sorted so that the points an event passes
+// are a prefix; a binary search gives the length of that prefix, the event is
+// counted once in the cell of these lengths, and a suffix sum over every
+// dimension turns the cell counts into the yield of each grid point. Only the
+// filled cells are kept while binning; the dense table of the suffix sums is
+// only made when a pass writes its yields.
+//
+// The yields (truth category x number of protons, as in the main histograms)
+// of every grid point are written as the bdt_scan tree of each output file.
+//
+// SPEC is a ';' separated list of dimension=values, values being a comma
+// separated list or lo:hi:step:
+//   numu=0.1:0.5:0.1;other=-0.4,0,0.2;ncpi0=-0.05;ncpi0max=-0.4,1e9;nue=-1;br1=0,1
+// numu, other, ncpi0 and nue are lower bounds (score > value), ncpi0max an
+// upper bound (score < value), br1=1 requires exactly one 20br1 shower. A
+// dimension that is not given is not cut on.
+//
+// Include after set_vars.h and common_funtions.h.
+
+#ifndef BDT_SCAN_H
+#define BDT_SCAN_H
+
+#include <TDirectory.h>
+#include <TString.h>
+#include <TTree.h>
+#include <TVector3.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "blip_kernel.h"
+#include "event_summary.h"
+#include "selection_variants.h"
+
+
+enum BDTScanDim { kScanNumu = 0, kScanOther, kScanNcpi0, kScanNcpi0Max, kScanNue, kScan20br1, kNScanDims };
+
+const char* const kScanDimNames[kNScanDims] = {"numu", "other", "ncpi0", "ncpi0max", "nue", "br1"};
+
+const int kNScanCategories = kNSPCategories + 1;   // last: neither signal nor background
+const int kNScanProtonBins = 10;                   // as h_1gX_Nprotons, overflow in the last bin
+const long kMaxScanCells = 20000000;
+
+
+// One event that passed the score independent cuts
+struct BDTScanRecord {
+    float   score[4];        // numu, other, ncpi0, nue
+    uint8_t one20br1;        // shw_sp_n_20br1_showers == 1
+    int8_t  category;        // SPCategory
+    uint8_t WC_N_rec_protons;
+    uint8_t n_sig_all_regB_blips;
+};
+
+
+struct BDTScanSettings {
+    bool enabled = false;
+    std::vector<double> values[kNScanDims];   // sorted so the passing points are a prefix
+    std::vector<BDTScanRecord> records;       // this process's events, binned by FlushBDTScan
+    BlipGeometry geo;
+};
+
+inline BDTScanSettings gBDTScan;
+
+
+inline bool ParseBDTScan(const std::string& spec, BDTScanSettings& scan) {
+
+    for (int d = 0; d < kNScanDims; ++d) scan.values[d].clear();
+
+    std::stringstream ss(spec);
+    std::string item;
+    while (std::getline(ss, item, ';')) {
+        if (item.empty()) continue;
+        size_t eq = item.find('=');
+        int dim = -1;
+        for (int d = 0; d < kNScanDims; ++d)
+            if (eq != std::string::npos && item.compare(0, eq, kScanDimNames[d]) == 0 && eq == std::string(kScanDimNames[d]).size()) dim = d;
+        if (dim < 0) {
+            std::cerr << "ERROR: --bdt-scan: expected numu, other, ncpi0, ncpi0max, nue or br1 = values, got '" << item << "'\n";
+            return false;
+        }
+
+        std::string list = item.substr(eq + 1);
+        std::vector<double> numbers;
+        std::stringstream ls(list);
+        std::string value;
+        char sep = list.find(':') != std::string::npos ? ':' : ',';
+        while (std::getline(ls, value, sep)) {
+            char* end = nullptr;
+            double x = std::strtod(value.c_str(), &end);
+            if (value.empty() || *end != '\0' || std::isnan(x)) {
+                std::cerr << "ERROR: --bdt-scan: bad value '" << value << "' for " << kScanDimNames[dim] << "\n";
+                return false;
+            }
+            numbers.push_back(x);
+        }
+        if (sep == ':') {
+            if (numbers.size() != 3 || !(numbers[2] > 0) || numbers[1] < numbers[0]) {
+                std::cerr << "ERROR: --bdt-scan: expected lo:hi:step for " << kScanDimNames[dim] << ", got '" << list << "'\n";
+                return false;
+            }
+            double lo = numbers[0], hi = numbers[1], step = numbers[2];
+            numbers.clear();
+            for (long i = 0; lo + i * step <= hi + 1e-9 * step; ++i) numbers.push_back(lo + i * step);
+        }
+        scan.values[dim] = numbers;
+    }
+
+    // Defaults: no cut
+    if (scan.values[kScanNumu].empty())     scan.values[kScanNumu]     = {-kNoCut};
+    if (scan.values[kScanOther].empty())    scan.values[kScanOther]    = {-kNoCut};
+    if (scan.values[kScanNcpi0].empty())    scan.values[kScanNcpi0]    = {-kNoCut};
+    if (scan.values[kScanNcpi0Max].empty()) scan.values[kScanNcpi0Max] = {kNoCut};
+    if (scan.values[kScanNue].empty())      scan.values[kScanNue]      = {-kNoCut};
+    if (scan.values[kScan20br1].empty())    scan.values[kScan20br1]    = {0};
+
+    for (double b : scan.values[kScan20br1])
+        if (b != 0 && b != 1) {
+            std::cerr << "ERROR: --bdt-scan: br1 takes 0 (no requirement) and/or 1 (exactly one 20br1 shower)\n";
+            return false;
+        }
+
+    // Lower bounds ascending, the upper bound descending, br1 0 before 1:
+    // an event then passes a prefix of every dimension
+    long ncells = (long)kNScanCategories * kNScanProtonBins;
+    for (int d = 0; d < kNScanDims; ++d) {
+        std::vector<double>& v = scan.values[d];
+        if (d == kScanNcpi0Max) std::sort(v.begin(), v.end(), std::greater<double>());
+        else                    std::sort(v.begin(), v.end());
+        v.erase(std::unique(v.begin(), v.end()), v.end());
+        ncells *= v.size() + 1;
+    }
+    if (ncells > kMaxScanCells) {
+        std::cerr << "ERROR: --bdt-scan: grid too large (" << ncells << " cells, at most " << kMaxScanCells << ")\n";
+        return false;
+    }
+
+    scan.enabled = true;
+    return true;
+}
+
+
+// The cuts the scan does not touch (generic neutrino selection)
+inline bool PassesScoreIndependentCuts(const PreselectionInputs& in) {
+    return FirstFailedCut(kSignalCuts, in) > kCutVtxX;
+}
+
+// Keeps the current event. event: SummarizeEvent of the entry.
+inline void RecordBDTScanEvent(const PreselectionInputs& in, const EventSummary& event, const BlipBatch& blips,
+                               const TVector3& ShVtx, const TVector3& ShowerMomentum, float Radius) {
+    EventSummary summary = event;
+    ClassifyBlips(blips, ShVtx, ShowerMomentum, Radius, gBDTScan.geo);
+    SummarizeBlips(blips, gBDTScan.geo, false, summary);
+
+    BDTScanRecord r;
+    r.score[0] = in.single_photon_numu_score;
+    r.score[1] = in.single_photon_other_score;
+    r.score[2] = in.single_photon_ncpi0_score;
+    r.score[3] = in.single_photon_nue_score;
+    r.one20br1 = in.shw_sp_n_20br1_showers == 1;
+    r.category = summary.category;
+    r.WC_N_rec_protons     = std::min(summary.WC_N_rec_protons, 255);
+    r.n_sig_all_regB_blips = std::min(summary.n_sig_all_regB_blips(), 255);
+    gBDTScan.records.push_back(r);
+}
+
+
+// Yield table of one pass
+class BDTScanTable {
+public:
+
+    // Cell counts. Only the cells that have events are kept: the grid can have
+    // millions of cells, and every pass of every worker holds a table
+    void Book() {
+        fNCells = (long)kNScanCategories * kNScanProtonBins;
+        for (int d = 0; d < kNScanDims; ++d) fNCells *= gBDTScan.values[d].size() + 1;
+        fCells.clear();
+    }
+
+    // Counts every record in its cell
+    void Bin(const std::vector<BDTScanRecord>& records, bool AddBacktrackedBlips) {
+        for (const BDTScanRecord& r : records) {
+            long cell = 0;
+            for (int d = 0; d < kNScanDims; ++d)
+                cell = cell * (gBDTScan.values[d].size() + 1) + PassedPrefix(d, r);
+            int category = r.category < 0 ? kNSPCategories : r.category;
+            int nprotons = r.WC_N_rec_protons + (AddBacktrackedBlips ? r.n_sig_all_regB_blips : 0);
+            cell = (cell * kNScanCategories + category) * kNScanProtonBins + std::min(nprotons, kNScanProtonBins - 1);
+            fCells[cell]++;
+        }
+    }
+
+    // Worker shard: the filled cells as a (cell, count) tree in dir
+    void WriteShard(TDirectory* dir) {
+        dir->cd();
+        TTree tree(kCellTree, "BDT scan cell counts (internal)");
+        Long64_t cell;
+        double count;
+        tree.Branch("cell", &cell, "cell/L");
+        tree.Branch("count", &count, "count/D");
+        for (const auto& c : fCells) {
+            cell = c.first;
+            count = c.second;
+            tree.Fill();
+        }
+        tree.Write();
+    }
+
+    void MergeShard(TTree* tree) {
+        Long64_t cell;
+        double count;
+        tree->SetBranchAddress("cell", &cell);
+        tree->SetBranchAddress("count", &count);
+        for (Long64_t i = 0; i < tree->GetEntries(); ++i) {
+            tree->GetEntry(i);
+            fCells[cell] += count;
+        }
+    }
+
+    static constexpr const char* kCellTree = "bdt_scan_cells";
+
+    // Suffix sums over the grid dimensions, one bdt_scan entry per grid point
+    // in dir (written with dir)
+    void Write(TDirectory* dir) {
+        std::vector<double> sum(fNCells);
+        for (const auto& c : fCells) sum[c.first] = c.second;
+        fCells.clear();
+
+        // sum[cell] <- sum over the cells at or after it in every dimension
+        long stride = (long)kNScanCategories * kNScanProtonBins;
+        for (int d = kNScanDims - 1; d >= 0; --d) {
+            long n = gBDTScan.values[d].size() + 1;
+            for (long i = fNCells - 1; i >= 0; --i)
+                if ((i / stride) % n < n - 1) sum[i] += sum[i + stride];
+            stride *= n;
+        }
+
+        dir->cd();
+        TTree* tree = new TTree("bdt_scan", "Yields per BDT threshold grid point");
+        double cut[kNScanDims];
+        double yield[kNScanCategories][kNScanProtonBins];
+        double total;
+        tree->Branch("numu_score_min",  &cut[kScanNumu],     "numu_score_min/D");
+        tree->Branch("other_score_min", &cut[kScanOther],    "other_score_min/D");
+        tree->Branch("ncpi0_score_min", &cut[kScanNcpi0],    "ncpi0_score_min/D");
+        tree->Branch("ncpi0_score_max", &cut[kScanNcpi0Max], "ncpi0_score_max/D");
+        tree->Branch("nue_score_min",   &cut[kScanNue],      "nue_score_min/D");
+        tree->Branch("require_one_20br1_shower", &cut[kScan20br1], "require_one_20br1_shower/D");
+        tree->Branch("yield", yield, Form("yield[%d][%d]/D", kNScanCategories, kNScanProtonBins));
+        tree->Branch("total", &total, "total/D");
+
+        // Grid point g reads the cell g + 1 in every dimension
+        int g[kNScanDims] = {0};
+        while (true) {
+            long cell = 0;
+            for (int d = 0; d < kNScanDims; ++d) {
+                cut[d] = gBDTScan.values[d][g[d]];
+                cell = cell * (gBDTScan.values[d].size() + 1) + g[d] + 1;
+            }
+            total = 0;
+            for (int c = 0; c < kNScanCategories; ++c)
+                for (int p = 0; p < kNScanProtonBins; ++p) {
+                    yield[c][p] = sum[(cell * kNScanCategories + c) * kNScanProtonBins + p];
+                    total += yield[c][p];
+                }
+            tree->Fill();
+
+            int d = kNScanDims - 1;
+            while (d >= 0 && ++g[d] == (int)gBDTScan.values[d].size()) g[d--] = 0;
+            if (d < 0) break;
+        }
+        std::cout << "BDT scan: " << tree->GetEntries() << " grid points in bdt_scan" << std::endl;
+    }
+
+private:
+    std::unordered_map<long, double> fCells;   // cell -> events
+    long  fNCells = 0;
+
+    // Number of grid values of dimension d the record passes (a prefix)
+    static long PassedPrefix(int d, const BDTScanRecord& r) {
+        const std::vector<double>& v = gBDTScan.values[d];
+        switch (d) {
+            case kScan20br1:    return r.one20br1 ? (long)v.size() : (v[0] == 0 ? 1 : 0);
+            case kScanNcpi0Max: return std::lower_bound(v.begin(), v.end(), (double)r.score[2], std::greater<double>()) - v.begin();
+            default: {
+                double score = r.score[d == kScanNumu ? 0 : d == kScanOther ? 1 : d == kScanNcpi0 ? 2 : 3];
+                if (std::isnan(score)) return 0;
+                return std::lower_bound(v.begin(), v.end(), score) - v.begin();
+            }
+        }
+    }
+};
+
+#endif
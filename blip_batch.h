@@ -0,0 +1,123 @@
+// Structure-of-arrays copy of the saved blips of one event.
+//
+// The blip branches are separate std::vector branches (set_vars.h). The blip
+// loop used to index all ten of them with ->at(iBlip) for every blip. A
+// BlipBatch holds the same columns as plain arrays: it is filled once per
+// event and then read by every variant (and by the RDataFrame engine). The
+// arrays are 64-byte aligned, and they are kept from event to event, so they
+// are only reallocated when an event has more blips than any event before it.
+//
+// The element types are taken from the set_vars declarations, so include this
+// after set_vars.h.
+
+#ifndef BLIP_BATCH_H
+#define BLIP_BATCH_H
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+
+const size_t kBlipAlignment = 64;   // one cache line
+
+
+// Aligned array that only grows
+template <typename T>
+class BlipArray {
+public:
+    BlipArray() = default;
+    BlipArray(const BlipArray&) = delete;
+    BlipArray& operator=(const BlipArray&) = delete;
+    BlipArray(BlipArray&& other) noexcept : fData(other.fData), fCapacity(other.fCapacity) {
+        other.fData = nullptr;
+        other.fCapacity = 0;
+    }
+    ~BlipArray() { std::free(fData); }
+
+    // The contents are not kept when the array grows
+    void Reserve(size_t n) {
+        if (n <= fCapacity) return;
+        size_t capacity = std::max(n, 2 * fCapacity);
+        size_t bytes = (capacity * sizeof(T) + kBlipAlignment - 1) / kBlipAlignment * kBlipAlignment;
+        std::free(fData);
+        fData = static_cast<T*>(std::aligned_alloc(kBlipAlignment, bytes));
+        if (!fData) throw std::bad_alloc();
+        fCapacity = bytes / sizeof(T);
+    }
+
+    T*       data()       { return fData; }
+    const T* data() const { return fData; }
+    T&       operator[](size_t i)       { return fData[i]; }
+    const T& operator[](size_t i) const { return fData[i]; }
+
+private:
+    T*     fData = nullptr;
+    size_t fCapacity = 0;
+};
+
+
+// Element type of a set_vars blip branch (std::vector<T>*)
+template <typename V> using BlipElementOf = typename std::remove_pointer<V>::type::value_type;
+
+
+struct BlipBatch {
+
+    size_t n = 0;   // number of blips of the current event
+
+    BlipArray<BlipElementOf<decltype(blip_x)>>              x;
+    BlipArray<BlipElementOf<decltype(blip_y)>>              y;
+    BlipArray<BlipElementOf<decltype(blip_z)>>              z;
+    BlipArray<BlipElementOf<decltype(blip_energy)>>         energy;
+    BlipArray<BlipElementOf<decltype(blip_nplanes)>>        nplanes;
+    BlipArray<BlipElementOf<decltype(blip_touchtrk)>>       touchtrk;
+    BlipArray<BlipElementOf<decltype(blip_pl2_bydeadwire)>> pl2_bydeadwire;
+    BlipArray<BlipElementOf<decltype(blip_proxtrkdist)>>    proxtrkdist;
+    BlipArray<BlipElementOf<decltype(blip_true_g4id)>>      true_g4id;
+    BlipArray<BlipElementOf<decltype(blip_true_pdg)>>       true_pdg;
+
+    // All columns, in the order Fill() takes them
+    auto Columns() {
+        return std::tie(x, y, z, energy, nplanes, touchtrk, pl2_bydeadwire, proxtrkdist, true_g4id, true_pdg);
+    }
+
+    BlipBatch() { Reserve(256); }
+
+    void Reserve(size_t nblips) {
+        std::apply([nblips](auto&... column) { (column.Reserve(nblips), ...); }, Columns());
+    }
+
+    // Copies nblips blips from the blip columns of one event (std::vector or
+    // RVec), given in the order of the members above. If a column is shorter
+    // than nblips, only the blips present in every column are kept.
+    template <typename... Sources>
+    size_t Fill(size_t nblips, const Sources&... sources) {
+        static_assert(sizeof...(Sources) == 10, "BlipBatch::Fill takes the 10 blip columns");
+
+        n = std::min({nblips, (size_t)sources.size()...});
+        if (n < nblips && !fWarnedShort) {
+            std::cerr << "WARNING: blip branches shorter than nblips_saved (" << n << " < " << nblips
+                      << "), using the first " << n << " blips\n";
+            fWarnedShort = true;
+        }
+
+        Reserve(n);
+        std::apply([&](auto&... column) { (std::copy_n(sources.data(), n, column.data()), ...); }, Columns());
+        return n;
+    }
+
+    // Fills the batch from the set_vars blip branches of the current entry
+    size_t FillFromBranches() {
+        return Fill(nblips_saved > 0 ? (size_t)nblips_saved : 0,
+                    *blip_x, *blip_y, *blip_z, *blip_energy, *blip_nplanes, *blip_touchtrk,
+                    *blip_pl2_bydeadwire, *blip_proxtrkdist, *blip_true_g4id, *blip_true_pdg);
+    }
+
+private:
+    bool fWarnedShort = false;
+};
+
+#endif
@@ -0,0 +1,213 @@
+// Blip geometry of one event in one pass over a BlipBatch.
+//
+// The blip loop used to build a TVector3 per blip, subtract the shower vertex
+// twice, and then call calculateAngleBetweenVectors,
+// calculateCosineAngleBetweenVectors, IsWithinSphereOutsideConic and
+// IsBackTrackedBlip, each recomputing the same norms and dot products.
+// ClassifyBlips() computes the blip-shower vertex distance and the cosine of
+// every blip at once (4 blips per AVX2 instruction when built with -mavx2,
+// otherwise the same arithmetic one blip at a time), applies the sphere cuts,
+// and only then, for the sphere blips, takes the angle.
+//
+// Only partly done: the cone and region A/B tests are not in the kernel yet.
+// Their definitions live in common_funtions.h, which is not part of this
+// tree, so each sphere blip still builds a TVector3 for
+// IsWithinSphereOutsideConic, and IsBackTrackedBlip is called with the
+// precomputed distance and cosine. Once the definitions are here, both
+// should be computed from the cosine above and checked against the helpers
+// with --check-blip-kernel.
+//
+// Everything is computed in double as with TVector3, so the results are those
+// of the helpers. --check-blip-kernel recomputes every blip with the helpers
+// and reports any difference.
+//
+// Include after set_vars.h and common_funtions.h.
+
+#ifndef BLIP_KERNEL_H
+#define BLIP_KERNEL_H
+
+#include <TMath.h>
+#include <TVector3.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <iostream>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include "blip_batch.h"
+
+
+// Per-blip classification, one int of BlipFlag bits per saved blip
+enum BlipFlag {
+    kBlipSphere   = 1 << 0,   // 3D blip, not touching a track, away from tracks, within Radius of the shower vertex
+    kBlipSignal   = 1 << 1,   // sphere blip outside the shower cone (IsWithinSphereOutsideConic)
+    kBlipRegB     = 1 << 2,   // IsBackTrackedBlip (region B), otherwise region A
+    kBlipMC       = 1 << 3,   // blip_true_g4id > 0, otherwise overlay
+    kBlipTruthBit = 4         // BlipTruth class stored from this bit on
+};
+
+enum BlipTruth { kBlipTruthProton = 0, kBlipTruthElectron, kBlipTruthHeavyNucleus, kBlipTruthOther };
+
+const int kBlipTruthMask = 3 << kBlipTruthBit;
+
+inline int BlipTruthClass(int pdg) {
+    if (pdg == 2212) return kBlipTruthProton;
+    if (pdg == 11 || pdg == -11) return kBlipTruthElectron;
+    if (pdg == 1000010020 || pdg == 1000010030 ||   // D, T
+        pdg == 1000020030 || pdg == 1000020040)     // He3, alpha
+        return kBlipTruthHeavyNucleus;
+    return kBlipTruthOther;
+}
+
+
+// Output of ClassifyBlips, indexed like the BlipBatch. Angles are only
+// computed for sphere blips (0 otherwise).
+struct BlipGeometry {
+    size_t n = 0;
+    BlipArray<float>  dist2vtx;   // |blip - shower vertex| [cm]
+    BlipArray<double> cosangle;   // cosine of the angle to the shower direction
+    BlipArray<double> angle;      // same angle [degrees]
+    BlipArray<int>    flags;      // BlipFlag bits
+
+    void Reserve(size_t nblips) {
+        dist2vtx.Reserve(nblips);
+        cosangle.Reserve(nblips);
+        angle.Reserve(nblips);
+        flags.Reserve(nblips);
+    }
+};
+
+
+// Distance to (vx,vy,vz) and cosine of the angle to the direction (sx,sy,sz)
+// of n blips. smag is |(sx,sy,sz)|.
+template <typename Coord>
+inline void BlipDistanceCosine(const Coord* x, const Coord* y, const Coord* z, size_t n,
+                               double vx, double vy, double vz, double sx, double sy, double sz, double smag,
+                               float* dist, double* cosangle, size_t first = 0) {
+    for (size_t i = first; i < n; ++i) {
+        double dx = x[i] - vx, dy = y[i] - vy, dz = z[i] - vz;
+        double mag = std::sqrt(dx * dx + dy * dy + dz * dz);
+        dist[i] = mag;
+        cosangle[i] = (dx * sx + dy * sy + dz * sz) / (mag * smag);
+    }
+}
+
+#if defined(__AVX2__)
+// float coordinates: 4 blips at a time, widened to double
+inline void BlipDistanceCosine(const float* x, const float* y, const float* z, size_t n,
+                               double vx, double vy, double vz, double sx, double sy, double sz, double smag,
+                               float* dist, double* cosangle) {
+    const __m256d Vx = _mm256_set1_pd(vx), Vy = _mm256_set1_pd(vy), Vz = _mm256_set1_pd(vz);
+    const __m256d Sx = _mm256_set1_pd(sx), Sy = _mm256_set1_pd(sy), Sz = _mm256_set1_pd(sz);
+    const __m256d Smag = _mm256_set1_pd(smag);
+
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d dx = _mm256_sub_pd(_mm256_cvtps_pd(_mm_loadu_ps(x + i)), Vx);
+        __m256d dy = _mm256_sub_pd(_mm256_cvtps_pd(_mm_loadu_ps(y + i)), Vy);
+        __m256d dz = _mm256_sub_pd(_mm256_cvtps_pd(_mm_loadu_ps(z + i)), Vz);
+        // No FMA: same rounding as the scalar dx*dx + dy*dy + dz*dz
+        __m256d mag2 = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy)), _mm256_mul_pd(dz, dz));
+        __m256d dot  = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(dx, Sx), _mm256_mul_pd(dy, Sy)), _mm256_mul_pd(dz, Sz));
+        __m256d mag  = _mm256_sqrt_pd(mag2);
+        _mm_storeu_ps(dist + i, _mm256_cvtpd_ps(mag));
+        _mm256_storeu_pd(cosangle + i, _mm256_div_pd(dot, _mm256_mul_pd(mag, Smag)));
+    }
+    BlipDistanceCosine<float>(x, y, z, n, vx, vy, vz, sx, sy, sz, smag, dist, cosangle, i);
+}
+#endif
+
+
+// --check-blip-kernel: compare ClassifyBlips with the common_funtions.h helpers
+struct BlipKernelCheck {
+    bool enabled = false;
+    std::atomic<long> nblips{0};      // atomic: the rdf engine classifies blips on several threads
+    std::atomic<long> nmismatch{0};
+};
+
+inline BlipKernelCheck gBlipKernelCheck;
+
+
+// The per-blip code of the hand-written loop, for the check
+inline void CheckBlipGeometry(const BlipBatch& blips, const TVector3& ShVtx, const TVector3& ShowerMomentum,
+                              float Radius, const BlipGeometry& geo) {
+
+    for (size_t iBlip = 0; iBlip < blips.n; ++iBlip) {
+        TVector3 BlipVtx(blips.x[iBlip], blips.y[iBlip], blips.z[iBlip]);
+        TVector3 ShowerVtx2Blip = BlipVtx - ShVtx;
+        float dist2vtx = (BlipVtx - ShVtx).Mag();
+        double angle = 0, cosangle = 0;
+        int flags = 0;
+
+        if (blips.nplanes[iBlip] > 1 && blips.touchtrk[iBlip] == 0 && blips.pl2_bydeadwire[iBlip] == 0 &&
+            blips.proxtrkdist[iBlip] > 15 && dist2vtx < Radius) {
+            angle    = calculateAngleBetweenVectors(ShowerVtx2Blip, ShowerMomentum);
+            cosangle = calculateCosineAngleBetweenVectors(ShowerVtx2Blip, ShowerMomentum);
+            flags |= kBlipSphere;
+            if (IsWithinSphereOutsideConic(ShVtx, ShowerMomentum, BlipVtx, Radius)) {
+                flags |= kBlipSignal;
+                if (IsBackTrackedBlip(dist2vtx, cosangle)) flags |= kBlipRegB;
+            }
+        }
+
+        int kernelFlags = geo.flags[iBlip] & (kBlipSphere | kBlipSignal | kBlipRegB);
+        // Tolerances only cover rounding (FMA contraction, acos near 0 and 180 degrees)
+        bool same = kernelFlags == flags &&
+                    std::abs(dist2vtx - geo.dist2vtx[iBlip]) <= 1e-6f * dist2vtx &&
+                    std::abs(cosangle - geo.cosangle[iBlip]) < 1e-12 &&
+                    std::abs(angle - geo.angle[iBlip]) < 1e-6;
+
+        gBlipKernelCheck.nblips++;
+        if (!same && gBlipKernelCheck.nmismatch++ < 10)
+            std::cerr << "WARNING: blip kernel mismatch, blip " << iBlip << ": flags " << kernelFlags << "/" << flags
+                      << " dist2vtx " << geo.dist2vtx[iBlip] << "/" << dist2vtx
+                      << " cos " << geo.cosangle[iBlip] << "/" << cosangle
+                      << " angle " << geo.angle[iBlip] << "/" << angle << "\n";
+    }
+}
+
+
+// Fills geo with the distance, cosine, angle and BlipFlag bits of every blip
+// of the batch
+inline void ClassifyBlips(const BlipBatch& blips, const TVector3& ShVtx, const TVector3& ShowerMomentum,
+                          float Radius, BlipGeometry& geo) {
+
+    size_t n = blips.n;
+    geo.Reserve(n);
+    geo.n = n;
+
+    BlipDistanceCosine(blips.x.data(), blips.y.data(), blips.z.data(), n,
+                       ShVtx.X(), ShVtx.Y(), ShVtx.Z(),
+                       ShowerMomentum.X(), ShowerMomentum.Y(), ShowerMomentum.Z(), ShowerMomentum.Mag(),
+                       geo.dist2vtx.data(), geo.cosangle.data());
+
+    // Sphere cuts, branch free so the compiler can vectorize them
+    for (size_t i = 0; i < n; ++i)
+        geo.flags[i] = (blips.nplanes[i] > 1 && blips.touchtrk[i] == 0 && blips.pl2_bydeadwire[i] == 0 &&
+                        blips.proxtrkdist[i] > 15 && geo.dist2vtx[i] < Radius) ? kBlipSphere : 0;
+
+    for (size_t i = 0; i < n; ++i) {
+        if (!(geo.flags[i] & kBlipSphere)) {
+            geo.cosangle[i] = 0;
+            geo.angle[i] = 0;
+            continue;
+        }
+
+        geo.angle[i] = std::acos(std::max(-1.0, std::min(1.0, geo.cosangle[i]))) * TMath::RadToDeg();
+
+        // Per blip TVector3 until the cone test is in the kernel (see the top of the file)
+        if (IsWithinSphereOutsideConic(ShVtx, ShowerMomentum, TVector3(blips.x[i], blips.y[i], blips.z[i]), Radius)) {
+            geo.flags[i] |= kBlipSignal;
+            if (IsBackTrackedBlip(geo.dist2vtx[i], geo.cosangle[i])) geo.flags[i] |= kBlipRegB;
+        }
+        if (blips.true_g4id[i] > 0) geo.flags[i] |= kBlipMC | (BlipTruthClass(blips.true_pdg[i]) << kBlipTruthBit);
+    }
+
+    if (gBlipKernelCheck.enabled) CheckBlipGeometry(blips, ShVtx, ShowerMomentum, Radius, geo);
+}
+
+#endif
@@ -0,0 +1,283 @@
+// Branch manifest for the 1gX selection.
+//
+// setBranches*() bind every branch the set_vars headers know about, and
+// GetEntry() then reads and unzips all of them even though the selection only
+// looks at a few dozen. The manifest below lists, per input tree and per stage
+// of the event loop, the branches that are actually used. ApplyBranchManifest()
+// switches everything else off with SetBranchStatus so GetEntry() only touches
+// those baskets.
+//
+// When a new variable is used in the loop, add it here as well, otherwise it
+// will silently keep its value from the last event that read it.
+
+#ifndef BRANCH_MANIFEST_H
+#define BRANCH_MANIFEST_H
+
+#include <TFile.h>
+#include <TTree.h>
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+
+// Input tree paths inside the reco2 files
+const char* const kPeLEETree  = "nuselection/NeutrinoSelectionFilter";
+const char* const kPFevalTree = "wcpselection/T_PFeval";
+const char* const kKINETree   = "wcpselection/T_KINEvars";
+const char* const kBDTTree    = "wcpselection/T_BDTvars";
+const char* const kEvalTree   = "wcpselection/T_eval";
+
+
+// Stages of the event loop, in the order they run
+enum ManifestStage {
+    kStagePreselection = 0,   // 1gX preselection cuts (every event)
+    kStageBlips,              // shower vertex/direction + blip loop
+    kStageProtons,            // WC proton counting (Get_Nproton, is_0p)
+    kStageTruth,              // signal/background breakdown categories
+    kNManifestStages
+};
+
+
+struct ManifestEntry {
+    const char*   tree;
+    ManifestStage stage;
+    const char*   branch;
+};
+
+
+inline const std::vector<ManifestEntry>& BranchManifest() {
+    static const std::vector<ManifestEntry> manifest = {
+
+        // --- Preselection ---
+        {kPeLEETree,  kStagePreselection, "crtveto"},
+        {kKINETree,   kStagePreselection, "kine_reco_Enu"},
+        {kBDTTree,    kStagePreselection, "shw_sp_n_20mev_showers"},
+        {kPFevalTree, kStagePreselection, "reco_nuvtxX"},
+        {kBDTTree,    kStagePreselection, "single_photon_numu_score"},
+        {kBDTTree,    kStagePreselection, "single_photon_other_score"},
+        {kBDTTree,    kStagePreselection, "single_photon_ncpi0_score"},
+        {kBDTTree,    kStagePreselection, "single_photon_nue_score"},
+        {kBDTTree,    kStagePreselection, "shw_sp_n_20br1_showers"},
+        {kPeLEETree,  kStagePreselection, "run"},   // event id, for the prescale (event_range.h, kPrescaleBranches)
+        {kPeLEETree,  kStagePreselection, "sub"},
+        {kPeLEETree,  kStagePreselection, "evt"},
+
+        // --- Blips ---
+        {kPeLEETree,  kStageBlips, "reco_nu_vtx_x"},
+        {kPeLEETree,  kStageBlips, "reco_nu_vtx_y"},
+        {kPeLEETree,  kStageBlips, "reco_nu_vtx_z"},
+        {kPFevalTree, kStageBlips, "reco_showervtxX"},
+        {kPFevalTree, kStageBlips, "reco_showervtxY"},
+        {kPFevalTree, kStageBlips, "reco_showervtxZ"},
+        {kPFevalTree, kStageBlips, "reco_showerMomentum"},
+        {kPeLEETree,  kStageBlips, "nblips_saved"},
+        {kPeLEETree,  kStageBlips, "blip_x"},
+        {kPeLEETree,  kStageBlips, "blip_y"},
+        {kPeLEETree,  kStageBlips, "blip_z"},
+        {kPeLEETree,  kStageBlips, "blip_energy"},
+        {kPeLEETree,  kStageBlips, "blip_nplanes"},
+        {kPeLEETree,  kStageBlips, "blip_touchtrk"},
+        {kPeLEETree,  kStageBlips, "blip_pl2_bydeadwire"},
+        {kPeLEETree,  kStageBlips, "blip_proxtrkdist"},
+        {kPeLEETree,  kStageBlips, "blip_true_g4id"},
+        {kPeLEETree,  kStageBlips, "blip_true_pdg"},
+
+        // --- Protons ---
+        {kBDTTree,    kStageProtons, "numu_cc_flag"},
+        {kKINETree,   kStageProtons, "kine_nparticles"},
+        {kKINETree,   kStageProtons, "kine_energy_particle"},
+        {kKINETree,   kStageProtons, "kine_particle_type"},
+
+        // --- Truth categories ---
+        {kEvalTree,   kStageTruth, "match_completeness_energy"},
+        {kEvalTree,   kStageTruth, "truth_energyInside"},
+        {kEvalTree,   kStageTruth, "truth_isCC"},
+        {kEvalTree,   kStageTruth, "truth_vtxInside"},
+        {kEvalTree,   kStageTruth, "truth_nuPdg"},
+        {kPFevalTree, kStageTruth, "truth_single_photon"},
+        {kPFevalTree, kStageTruth, "truth_NCDelta"},
+        {kPFevalTree, kStageTruth, "truth_showerMother"},
+        {kPFevalTree, kStageTruth, "truth_Npi0"},
+        {kPFevalTree, kStageTruth, "truth_muonMomentum"},
+    };
+    return manifest;
+}
+
+
+// Branch names the manifest requests from one tree
+inline std::vector<std::string> ManifestBranches(const std::string& treePath) {
+    std::vector<std::string> branches;
+    for (const ManifestEntry& entry : BranchManifest())
+        if (treePath == entry.tree) branches.push_back(entry.branch);
+    return branches;
+}
+
+
+// Disables every branch of the tree, then re-enables the ones in the manifest.
+// Must be called after setBranches*() so the addresses are already bound.
+// disableOthers = false only enables (several manifest trees in one tree).
+inline void ApplyBranchManifest(TTree* tree, const std::string& treePath, bool disableOthers = true) {
+
+    if (disableOthers) tree->SetBranchStatus("*", false);
+
+    for (const std::string& name : ManifestBranches(treePath)) {
+        if (!tree->GetBranch(name.c_str())) {
+            std::cerr << "WARNING: Branch manifest: '" << name << "' not found in "
+                      << treePath << "\n";
+            continue;
+        }
+        tree->SetBranchStatus(name.c_str(), true);
+    }
+}
+
+
+// One input tree read in the event loop, with the bytes GetEntry() returned.
+// cutBranches are the preselection branches (read for every entry), the
+// first nIdBranches of them the event id the prescale needs (read first, so
+// the others are only read for the entries the prescale keeps),
+// payloadBranches the rest of the manifest (read only for passing entries).
+// tree can be a TChain: treeNumber is the chain element the branch pointers
+// were looked up in, and they are looked up again when the chain moves on.
+// entryMap, if not empty, gives the entry of this tree holding the event of
+// each loop entry (-1: event missing), see event_alignment.h.
+// If timed (--io-report), the reads are counted and timed as well.
+struct InputTree {
+    const char* path;
+    TTree*      tree;
+    Long64_t    bytesRead;
+    std::vector<TBranch*> cutBranches;
+    size_t      nIdBranches = 0;
+    std::vector<TBranch*> payloadBranches;
+    int         treeNumber = -1;
+    std::vector<Long64_t> entryMap;
+    bool        timed = false;
+    Long64_t    entriesRead = 0;
+    double      readSeconds = 0;
+};
+
+
+// Adds the wall time of one read to in.readSeconds, if the tree is timed
+class ReadTimer {
+public:
+    explicit ReadTimer(InputTree& in) : fIn(in) {
+        if (fIn.timed) fStart = std::chrono::steady_clock::now();
+    }
+    ~ReadTimer() {
+        if (fIn.timed) fIn.readSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - fStart).count();
+    }
+private:
+    InputTree& fIn;
+    std::chrono::steady_clock::time_point fStart;
+};
+
+
+// Entry of the tree to read for loop entry `entry`
+inline Long64_t TreeEntry(const InputTree& in, Long64_t entry) {
+    return in.entryMap.empty() ? entry : in.entryMap[entry];
+}
+
+// False if one of the trees does not have the event of loop entry `entry`
+inline bool HasEvent(const std::vector<InputTree>& inputs, Long64_t entry) {
+    for (const InputTree& in : inputs)
+        if (TreeEntry(in, entry) < 0) return false;
+    return true;
+}
+
+
+// PeLEE event id branches, all the prescale looks at (event_range.h)
+const char* const kPrescaleBranches[] = {"run", "sub", "evt"};
+
+inline bool IsPrescaleBranch(const ManifestEntry& entry) {
+    if (std::string(entry.tree) != kPeLEETree) return false;
+    for (const char* name : kPrescaleBranches)
+        if (std::string(entry.branch) == name) return true;
+    return false;
+}
+
+
+// Looks up the TBranch of every manifest entry once, split by stage, with
+// the prescale branches first among the cut branches.
+// Must be called after ApplyBranchManifest().
+inline void SplitBranchesByStage(InputTree& in) {
+
+    in.cutBranches.clear();
+    in.payloadBranches.clear();
+    in.nIdBranches = 0;
+
+    for (const ManifestEntry& entry : BranchManifest()) {
+        if (std::string(in.path) != entry.tree) continue;
+        TBranch* branch = in.tree->GetBranch(entry.branch);
+        if (!branch) continue;
+        if (entry.stage != kStagePreselection) in.payloadBranches.push_back(branch);
+        else if (IsPrescaleBranch(entry))      in.cutBranches.insert(in.cutBranches.begin() + in.nIdBranches++, branch);
+        else                                   in.cutBranches.push_back(branch);
+    }
+}
+
+
+// Loads the chain element holding the entry and returns the entry number
+// inside it (the entry itself for a plain TTree).
+inline Long64_t LoadInputEntry(InputTree& in, Long64_t entry) {
+    Long64_t local = in.tree->LoadTree(entry);
+    if (in.tree->GetTreeNumber() != in.treeNumber) {
+        SplitBranchesByStage(in);
+        in.treeNumber = in.tree->GetTreeNumber();
+    }
+    return local;
+}
+
+// Phase one, first: the event id the prescale needs (nothing for the trees
+// without it)
+inline void ReadPrescaleBranches(InputTree& in, Long64_t entry) {
+    ReadTimer timer(in);
+    Long64_t local = LoadInputEntry(in, TreeEntry(in, entry));
+    for (size_t i = 0; i < in.nIdBranches; ++i) in.bytesRead += in.cutBranches[i]->GetEntry(local);
+}
+
+// Phase one, for the entries the prescale keeps: the other scalars the
+// preselection cuts on. Must follow ReadPrescaleBranches() for the same entry.
+inline void ReadCutBranches(InputTree& in, Long64_t entry) {
+    ReadTimer timer(in);
+    in.entriesRead++;
+    Long64_t local = LoadInputEntry(in, TreeEntry(in, entry));
+    for (size_t i = in.nIdBranches; i < in.cutBranches.size(); ++i) in.bytesRead += in.cutBranches[i]->GetEntry(local);
+}
+
+// Phase two: blip vectors, kine arrays and truth, for entries that passed.
+// Must follow ReadCutBranches() for the same entry.
+inline void ReadPayloadBranches(InputTree& in, Long64_t entry) {
+    ReadTimer timer(in);
+    Long64_t local = in.tree->LoadTree(TreeEntry(in, entry));
+    for (TBranch* branch : in.payloadBranches) in.bytesRead += branch->GetEntry(local);
+}
+
+
+// --all-branches: every branch of the entry in one go
+inline void ReadAllBranches(InputTree& in, Long64_t entry) {
+    ReadTimer timer(in);
+    in.entriesRead++;
+    in.bytesRead += in.tree->GetEntry(TreeEntry(in, entry));
+}
+
+
+// fileBytesRead: compressed bytes read from the input files (all workers)
+inline void PrintReadSummary(const std::vector<InputTree>& inputs, Long64_t fileBytesRead, bool manifestApplied,
+                             Long64_t nevents, Long64_t npayload) {
+
+    std::cout << "\n ---- INPUT READ SUMMARY ----\n";
+    if (manifestApplied)
+        std::cout << " Entries read: " << nevents << " cut branches, " << npayload << " full payload\n";
+    for (const InputTree& in : inputs) {
+        std::cout << " " << std::left << std::setw(38) << in.path
+                  << " active branches: " << std::setw(4)
+                  << (manifestApplied ? std::to_string(ManifestBranches(in.path).size()) : std::string("all"))
+                  << " bytes read (unzipped): " << in.bytesRead << "\n";
+    }
+    std::cout << " Total bytes read from file (compressed): " << fileBytesRead << "\n";
+    std::cout << " ----------------------------\n";
+}
+
+#endif
@@ -0,0 +1,209 @@
+// A/B comparison of two configurations of anamacro_1gX_blips_signal on the
+// same input, e.g. the serial loop against --threads 8 or --engine rdf.
+//
+// Both configurations are run one after the other, each with the variant
+// output directories moved under <workdir>/A or <workdir>/B. The wall time,
+// CPU time (user + system, workers included) and peak RSS (largest process)
+// of each run are printed with the speedup of B over A, then every output
+// file of B is compared bin by bin with the one of A (output_compare.h).
+// The exit code is 0 if all outputs agree, 2 if they do not, 1 on errors, so
+// it can gate performance changes on unchanged results.
+
+#include <TFile.h>
+#include <TString.h>
+#include <TSystem.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fcntl.h>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+#include "output_compare.h"
+#include "shard_merge.h"
+
+
+struct RunStats {
+    std::string name;
+    double realSeconds = 0;
+    double cpuSeconds = 0;
+    long   peakRSSkB = 0;
+    Long64_t events = 0;   // entries run, from event_range/
+};
+
+
+// Runs the selection with args, stdout and stderr to log. False if it fails
+bool RunSelection(const std::vector<std::string>& args, const std::string& log, RunStats& stats) {
+    std::cout << stats.name << ":";
+    for (const std::string& arg : args) std::cout << " " << arg;
+    std::cout << std::endl;
+
+    auto start = std::chrono::steady_clock::now();
+    pid_t pid = fork();
+    if (pid < 0) {
+        std::cerr << "ERROR: fork() failed\n";
+        return false;
+    }
+    if (pid == 0) {
+        int fd = open(log.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd >= 0) {
+            dup2(fd, STDOUT_FILENO);
+            dup2(fd, STDERR_FILENO);
+            close(fd);
+        }
+        std::vector<char*> argv;
+        for (const std::string& arg : args) argv.push_back(const_cast<char*>(arg.c_str()));
+        argv.push_back(nullptr);
+        execvp(argv[0], argv.data());
+        _exit(127);
+    }
+
+    int status = 0;
+    struct rusage usage;
+    if (wait4(pid, &status, 0, &usage) < 0) {
+        std::cerr << "ERROR: wait4() failed\n";
+        return false;
+    }
+    stats.realSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    stats.cpuSeconds  = usage.ru_utime.tv_sec + usage.ru_utime.tv_usec * 1e-6 + usage.ru_stime.tv_sec + usage.ru_stime.tv_usec * 1e-6;
+    stats.peakRSSkB   = usage.ru_maxrss;
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        std::cerr << "ERROR: " << stats.name << " failed, see " << log << "\n";
+        return false;
+    }
+    return true;
+}
+
+// The .root files of a directory
+std::vector<std::string> ListRootFiles(const std::string& dir) {
+    std::vector<std::string> files;
+    void* handle = gSystem->OpenDirectory(dir.c_str());
+    if (!handle) return files;
+    while (const char* entry = gSystem->GetDirEntry(handle)) {
+        std::string name = entry;
+        if (name.size() > 5 && name.compare(name.size() - 5, 5, ".root") == 0) files.push_back(name);
+    }
+    gSystem->FreeDirectory(handle);
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
+
+int main(int argc, char** argv) {
+
+    std::string exe = "./anamacro_1gX_blips_signal", workDir = "compare_runs";
+    std::string optionsA, optionsB;
+    double tolerance = 1e-6;
+    std::vector<std::string> selection;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--exe" && i + 1 < argc) exe = argv[++i];
+        else if (arg == "--workdir" && i + 1 < argc) workDir = argv[++i];
+        else if (arg == "--a" && i + 1 < argc) optionsA = argv[++i];
+        else if (arg == "--b" && i + 1 < argc) optionsB = argv[++i];
+        else if (arg == "--tolerance" && i + 1 < argc) tolerance = std::atof(argv[++i]);
+        else selection.push_back(arg);
+    }
+
+    std::vector<std::string> outDirs;
+    for (size_t i = 0; i + 1 < selection.size(); ++i) {
+        if (selection[i] != "--variant") continue;
+        size_t comma = selection[i + 1].find(',', selection[i + 1].find(',') + 1);
+        if (comma != std::string::npos) outDirs.push_back(selection[i + 1].substr(comma + 1));
+    }
+
+    if (outDirs.empty() || optionsA == optionsB || tolerance < 0) {
+        std::cerr << "Usage:\n"
+                  << argv[0] << " [--exe ./anamacro_1gX_blips_signal] [--workdir compare_runs] [--tolerance 1e-6]\n"
+                  << "       --a \"<options A>\" --b \"<options B>\" <input_file> <IsData> --variant <label>,<AddBacktrkBlips>,<outputDir> [...]\n"
+                  << "Example:\n"
+                  << argv[0] << " --a \"\" --b \"--threads 8\" file.root false --variant Signal,false,SIGNAL\n";
+        return 1;
+    }
+
+    // --- Runs ---
+    std::vector<RunStats> runs(2);
+    runs[0].name = "A";
+    runs[1].name = "B";
+    for (RunStats& run : runs) {
+        std::string dir = workDir + "/" + run.name;
+        gSystem->mkdir(dir.c_str(), true);
+        std::vector<std::string> args = {exe};
+        for (size_t i = 0; i < selection.size(); ++i) {
+            args.push_back(selection[i]);
+            if (selection[i] != "--variant" || i + 1 >= selection.size()) continue;
+            std::string spec = selection[++i];
+            size_t comma = spec.find(',', spec.find(',') + 1);
+            args.push_back(comma == std::string::npos ? spec : spec.substr(0, comma + 1) + dir + "/" + spec.substr(comma + 1));
+        }
+        std::istringstream options(run.name == "A" ? optionsA : optionsB);
+        for (std::string option; options >> option;) args.push_back(option);
+        if (!RunSelection(args, dir + ".log", run)) return 1;
+    }
+
+    // --- Output files, paired by name ---
+    std::vector<std::pair<std::string, std::string>> pairs;
+    bool missing = false;
+    for (const std::string& outDir : outDirs) {
+        std::string dirA = workDir + "/A/" + outDir, dirB = workDir + "/B/" + outDir;
+        std::vector<std::string> filesA = ListRootFiles(dirA), filesB = ListRootFiles(dirB);
+        for (const std::string& file : filesA) {
+            if (std::find(filesB.begin(), filesB.end(), file) == filesB.end()) {
+                std::cout << " MISMATCH " << dirA << "/" << file << " has no counterpart in " << dirB << "\n";
+                missing = true;
+            } else {
+                pairs.emplace_back(dirA + "/" + file, dirB + "/" + file);
+            }
+        }
+        for (const std::string& file : filesB)
+            if (std::find(filesA.begin(), filesA.end(), file) == filesA.end()) {
+                std::cout << " MISMATCH " << dirB << "/" << file << " has no counterpart in " << dirA << "\n";
+                missing = true;
+            }
+    }
+    if (pairs.empty()) {
+        std::cerr << "ERROR: no output files in " << workDir << "/A\n";
+        return 1;
+    }
+    for (size_t k = 0; k < runs.size(); ++k) {
+        std::unique_ptr<TFile> file(TFile::Open(k == 0 ? pairs[0].first.c_str() : pairs[0].second.c_str()));
+        EventRangeSettings range;
+        if (file && !file->IsZombie() && ReadEventRange(file.get(), range)) runs[k].events = range.end - range.begin;
+    }
+
+    // --- Performance ---
+    std::cout << "\n ---- PERFORMANCE ----\n"
+              << "     " << std::setw(10) << "wall [s]" << std::setw(10) << "CPU [s]" << std::setw(12) << "events/s"
+              << std::setw(15) << "peak RSS [MB]" << "\n";
+    for (const RunStats& run : runs)
+        std::cout << " " << run.name << "   " << std::setw(10) << run.realSeconds << std::setw(10) << run.cpuSeconds
+                  << std::setw(12) << (run.realSeconds > 0 ? run.events / run.realSeconds : 0)
+                  << std::setw(15) << run.peakRSSkB / 1024. << "\n";
+    const RunStats &a = runs[0], &b = runs[1];
+    if (a.events != b.events)
+        std::cout << " WARNING: A ran " << a.events << " entries and B " << b.events << "\n";
+    std::cout << " B/A: events/s x" << (b.realSeconds > 0 && a.events > 0 ? (b.events / b.realSeconds) / (a.events / a.realSeconds) : 0)
+              << ", CPU x" << (a.cpuSeconds > 0 ? b.cpuSeconds / a.cpuSeconds : 0)
+              << ", peak RSS x" << (a.peakRSSkB > 0 ? (double)b.peakRSSkB / a.peakRSSkB : 0) << "\n";
+
+    // --- Results ---
+    std::cout << "\n ---- OUTPUTS (tolerance " << tolerance << ") ----\n";
+    int failed = missing;
+    for (const auto& pair : pairs) {
+        CompareResult result;
+        if (!CompareFiles(pair.first, pair.second, tolerance, result)) return 1;
+        std::cout << " " << pair.first << " vs " << pair.second << ": " << result.histograms << " histograms, "
+                  << result.parameters << " parameters, " << result.trees << " trees, " << result.mismatches << " mismatches (max relative difference "
+                  << result.maxDiff << ")\n";
+        failed += result.mismatches > 0;
+    }
+    std::cout << (failed ? " OUTPUTS DIFFER" : " OUTPUTS AGREE") << std::endl;
+    return failed ? 2 : 0;
+}
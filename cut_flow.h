@@ -0,0 +1,140 @@
+// Cut flow and event loop timing (--cutflow).
+//
+// The preselection is a chain of cuts and the sphere blips pass a chain of
+// quality cuts, but only the final yes/no was visible. With --cutflow every
+// pass counts how many events survive each preselection cut in sequence
+// (selection_variants.h) and how many blips survive each blip cut, and the
+// event loop adds up the time spent in each of its stages. The tables are
+// written to every output file as histograms (h_cutflow_preselection,
+// h_cutflow_blips, h_cutflow_time) and to <output>.cutflow.json next to it.
+//
+// Without --cutflow the only cost is a test of gCutFlow.enabled per event
+// and per stage.
+
+#ifndef CUT_FLOW_H
+#define CUT_FLOW_H
+
+#include <TH1D.h>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "blip_kernel.h"
+#include "selection_variants.h"
+
+
+// Blip quality cuts of the sphere selection, in the order they are applied
+enum BlipCut { kBlipCutNplanes = 0, kBlipCutTouchTrk, kBlipCutDeadWire, kBlipCutProxTrkDist, kBlipCutRadius, kNBlipCuts };
+
+const char* const kBlipCutNames[kNBlipCuts] = {
+    "blip_nplanes", "blip_touchtrk", "blip_pl2_bydeadwire", "blip_proxtrkdist", "dist2vtx"
+};
+
+// Event loop stages timed with --cutflow
+enum LoopStage { kTimeReadCuts = 0, kTimePreselection, kTimeReadPayload, kTimeSkim, kTimeBlipBatch, kTimeFill, kNLoopStages };
+
+const char* const kLoopStageNames[kNLoopStages] = {
+    "read_preselection", "preselection", "read_payload", "skim", "blip_batch_and_summary", "fill"
+};
+
+
+struct CutFlowSettings {
+    bool   enabled = false;
+    double seconds[kNLoopStages] = {0};   // event loop of this process, all variants (summed over workers when merged)
+};
+
+inline CutFlowSettings gCutFlow;
+
+
+// Adds the time since the previous Lap() to one stage
+class StageTimer {
+public:
+    void Start() { fLast = std::chrono::steady_clock::now(); }
+    void Lap(int stage) {
+        auto now = std::chrono::steady_clock::now();
+        gCutFlow.seconds[stage] += std::chrono::duration<double>(now - fLast).count();
+        fLast = now;
+    }
+private:
+    std::chrono::steady_clock::time_point fLast;
+};
+
+
+// Counts of one selection pass. Entry 0 is the input, entry i+1 what is
+// left after cut i.
+struct CutFlow {
+    long eventCounts[kNPreselectionCuts + 1] = {0};
+    long blipCounts[kNBlipCuts + 1] = {0};
+
+    TH1D* hPreselection = nullptr;
+    TH1D* hBlips = nullptr;
+    TH1D* hTime = nullptr;
+
+    // In the current directory (the output file)
+    void Book() {
+        hPreselection = new TH1D("h_cutflow_preselection", "Events after each preselection cut", kNPreselectionCuts + 1, 0, kNPreselectionCuts + 1);
+        hBlips        = new TH1D("h_cutflow_blips", "Blips after each blip cut", kNBlipCuts + 1, 0, kNBlipCuts + 1);
+        hTime         = new TH1D("h_cutflow_time", "Event loop time per stage;;time [s]", kNLoopStages, 0, kNLoopStages);
+        hPreselection->GetXaxis()->SetBinLabel(1, "events");
+        hBlips->GetXaxis()->SetBinLabel(1, "blips");
+        for (int i = 0; i < kNPreselectionCuts; ++i) hPreselection->GetXaxis()->SetBinLabel(i + 2, kPreselectionCutNames[i]);
+        for (int i = 0; i < kNBlipCuts; ++i)         hBlips->GetXaxis()->SetBinLabel(i + 2, kBlipCutNames[i]);
+        for (int i = 0; i < kNLoopStages; ++i)       hTime->GetXaxis()->SetBinLabel(i + 1, kLoopStageNames[i]);
+    }
+
+    // failed: FirstFailedCut of the event
+    void CountEvent(int failed) {
+        for (int i = 0; i <= failed; ++i) eventCounts[i]++;
+    }
+
+    // The sphere cuts of ClassifyBlips, one at a time
+    void CountBlips(const BlipBatch& blips, const BlipGeometry& geo, float Radius) {
+        for (size_t i = 0; i < blips.n; ++i) {
+            int passed = 0;
+            if (blips.nplanes[i] > 1) passed++;
+            if (passed == 1 && blips.touchtrk[i] == 0) passed++;
+            if (passed == 2 && blips.pl2_bydeadwire[i] == 0) passed++;
+            if (passed == 3 && blips.proxtrkdist[i] > 15) passed++;
+            if (passed == 4 && geo.dist2vtx[i] < Radius) passed++;
+            for (int j = 0; j <= passed; ++j) blipCounts[j]++;
+        }
+    }
+
+    // Moves the counts and the loop time into the histograms, so they are
+    // written and merged (worker shards) with the other histograms of the pass
+    void Flush(const double* seconds) {
+        for (int i = 0; i <= kNPreselectionCuts; ++i) hPreselection->AddBinContent(i + 1, eventCounts[i]);
+        for (int i = 0; i <= kNBlipCuts; ++i)         hBlips->AddBinContent(i + 1, blipCounts[i]);
+        for (int i = 0; i < kNLoopStages; ++i)        hTime->AddBinContent(i + 1, seconds[i]);
+        hPreselection->SetEntries(hPreselection->GetBinContent(1));
+        hBlips->SetEntries(hBlips->GetBinContent(1));
+        std::fill(eventCounts, eventCounts + kNPreselectionCuts + 1, 0);
+        std::fill(blipCounts, blipCounts + kNBlipCuts + 1, 0);
+    }
+
+    bool WriteJSON(const std::string& path, const std::string& label) const {
+        std::ofstream out(path);
+        if (!out) {
+            std::cerr << "WARNING: could not write the cut flow to " << path << "\n";
+            return false;
+        }
+        out << "{\n  \"variant\": \"" << label << "\",\n  \"preselection\": [\n";
+        for (int i = 0; i <= kNPreselectionCuts; ++i)
+            out << "    {\"cut\": \"" << (i == 0 ? "events" : kPreselectionCutNames[i - 1]) << "\", \"pass\": "
+                << (long)hPreselection->GetBinContent(i + 1) << "}" << (i < kNPreselectionCuts ? ",\n" : "\n");
+        out << "  ],\n  \"blips\": [\n";
+        for (int i = 0; i <= kNBlipCuts; ++i)
+            out << "    {\"cut\": \"" << (i == 0 ? "blips" : kBlipCutNames[i - 1]) << "\", \"pass\": "
+                << (long)hBlips->GetBinContent(i + 1) << "}" << (i < kNBlipCuts ? ",\n" : "\n");
+        out << "  ],\n  \"time_s\": {\n";
+        for (int i = 0; i < kNLoopStages; ++i)
+            out << "    \"" << kLoopStageNames[i] << "\": " << hTime->GetBinContent(i + 1) << (i < kNLoopStages - 1 ? ",\n" : "\n");
+        out << "  }\n}\n";
+        return true;
+    }
+};
+
+#endif
@@ -0,0 +1,198 @@
+// Event alignment between the PeLEE tree and the Wire-Cell trees.
+//
+// The event loop reads entry i of every input tree as if they were the same
+// event. That only holds when the trees were filled together; a filtered or
+// partially reprocessed file breaks it without any error. Before the loop,
+// CheckAlignment() reads the (run, subrun, event) columns of the PeLEE tree
+// and of a Wire-Cell tree in one go and compares them entry by entry. If they
+// match the loop runs as before. If not, the Wire-Cell entry of every PeLEE
+// entry is looked up once through a TTreeIndex and stored in an entry map, so
+// the loop itself only does an array access per event.
+//
+// The TTreeIndex of each input file is cached in the working directory
+// (--index-dir, default evtindex/), as <input base name>.<hash of its path>.root,
+// so it is only built once per file and the input directory can be read-only.
+// The check runs once per job, in the parent before any worker is forked:
+// the workers inherit the entry maps.
+//
+// T_BDTvars and T_KINEvars have no event id columns; they are filled together
+// with T_eval, so they use the T_eval entry map.
+
+#ifndef EVENT_ALIGNMENT_H
+#define EVENT_ALIGNMENT_H
+
+#include <TChain.h>
+#include <TFile.h>
+#include <TSystem.h>
+#include <TTree.h>
+#include <TTreeIndex.h>
+
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+
+// Event id column names of each tree
+struct EventIdBranches {
+    const char* run;
+    const char* subrun;
+    const char* event;
+};
+
+const EventIdBranches kPeLEEIds = {"run", "sub",    "evt"};
+const EventIdBranches kWCIds    = {"run", "subrun", "event"};
+
+// TTreeIndex major/minor of the Wire-Cell trees (subrun < 10000)
+const char* const kIndexMajor = "run*10000+subrun";
+const char* const kIndexMinor = "event";
+
+inline Long64_t IndexMajor(Long64_t run, Long64_t subrun) { return run * 10000 + subrun; }
+
+inline std::string gEventIndexDir = "evtindex";   // --index-dir
+
+
+struct EventIds {
+    std::vector<Long64_t> run, subrun, event;
+};
+
+
+// Reads the id columns of every entry of the tree (or chain) with a single
+// TTree::Draw, i.e. one pass over three small branches. The branch manifest
+// may have switched them off (Draw does not read those): they are switched
+// on for the Draw and back to their status afterwards.
+inline bool ReadEventIds(TTree* tree, const EventIdBranches& ids, EventIds& out) {
+
+    const char* names[3] = {ids.run, ids.subrun, ids.event};
+    bool status[3];
+    for (int i = 0; i < 3; ++i) {
+        status[i] = tree->GetBranchStatus(names[i]);
+        tree->SetBranchStatus(names[i], true);
+    }
+
+    Long64_t n = tree->GetEntries();
+    tree->SetEstimate(n + 1);
+    Long64_t nread = tree->Draw(Form("%s:%s:%s", ids.run, ids.subrun, ids.event), "", "goff");
+    for (int i = 0; i < 3; ++i) tree->SetBranchStatus(names[i], status[i]);
+    if (nread != n) {
+        std::cerr << "ERROR: Could not read " << ids.run << "/" << ids.subrun << "/" << ids.event
+                  << " from " << tree->GetName() << "\n";
+        return false;
+    }
+
+    out.run.assign(tree->GetV1(), tree->GetV1() + n);
+    out.subrun.assign(tree->GetV2(), tree->GetV2() + n);
+    out.event.assign(tree->GetV3(), tree->GetV3() + n);
+    return true;
+}
+
+
+// True if both trees have the same events in the same order
+inline bool SameEventOrder(const EventIds& a, const EventIds& b) {
+
+    size_t n = a.run.size();
+    if (b.run.size() != n) return false;
+
+    Long64_t diff = 0;
+    for (size_t i = 0; i < n; ++i)
+        diff |= (a.run[i] ^ b.run[i]) | (a.subrun[i] ^ b.subrun[i]) | (a.event[i] ^ b.event[i]);
+    return diff == 0;
+}
+
+
+// Returns the (run*10000+subrun, event) index of one tree of one input file,
+// read from the cache next to the file or built and cached. The caller owns it.
+inline TTreeIndex* LoadOrBuildIndex(const std::string& file, const char* treePath) {
+
+    if (gSystem->AccessPathName(gEventIndexDir.c_str())) gSystem->mkdir(gEventIndexDir.c_str(), true);
+    std::string cacheFile = Form("%s/%s.%016zx.root", gEventIndexDir.c_str(), gSystem->BaseName(file.c_str()),
+                                 std::hash<std::string>()(file));
+    std::string key = treePath;
+    for (char& c : key) if (c == '/') c = '_';
+
+    // The cache is only used if it is newer than the input
+    FileStat_t inputStat, cacheStat;
+    bool haveCache = gSystem->GetPathInfo(cacheFile.c_str(), cacheStat) == 0 &&
+                     gSystem->GetPathInfo(file.c_str(), inputStat) == 0 &&
+                     cacheStat.fMtime >= inputStat.fMtime;
+
+    if (haveCache) {
+        TFile cache(cacheFile.c_str(), "READ");
+        TTreeIndex* index = cache.IsZombie() ? nullptr : cache.Get<TTreeIndex>(key.c_str());
+        if (index) return index;
+    }
+
+    TFile* input = TFile::Open(file.c_str());
+    TTree* tree = (input && !input->IsZombie()) ? (TTree*)input->Get(treePath) : nullptr;
+    if (!tree) {
+        std::cerr << "ERROR: cannot read " << treePath << " from " << file << " to build its index\n";
+        if (input) input->Close();
+        return nullptr;
+    }
+
+    std::cout << "Building event index of " << treePath << " in " << file << std::endl;
+    TTreeIndex* index = new TTreeIndex(tree, kIndexMajor, kIndexMinor);
+    index->SetTree(nullptr);
+
+    // Write to a temporary file and rename, so concurrent jobs never see a
+    // half-written cache. Keep any trees already cached for this file.
+    std::string tmpFile = cacheFile + Form(".%d", gSystem->GetPid());
+    if (haveCache)
+        gSystem->CopyFile(cacheFile.c_str(), tmpFile.c_str(), true);
+    TFile cache(tmpFile.c_str(), "UPDATE");
+    if (cache.IsZombie()) {
+        std::cerr << "WARNING: cannot write event index cache " << cacheFile << "\n";
+    } else {
+        cache.WriteTObject(index, key.c_str(), "Overwrite");
+        cache.Close();
+        gSystem->Rename(tmpFile.c_str(), cacheFile.c_str());
+    }
+
+    input->Close();
+    return index;
+}
+
+
+// Checks that the Wire-Cell chain wcChain holds the same events as the PeLEE
+// chain, in the same order. If it does, entryMap is left empty. Otherwise
+// entryMap[i] is the wcChain entry of PeLEE entry i, or -1 if that event is
+// missing from it. Both chains must be built from `files`, in that order.
+inline bool CheckAlignment(const std::vector<std::string>& files, TChain* pelee, TChain* wcChain,
+                           const char* wcPath, std::vector<Long64_t>& entryMap) {
+
+    entryMap.clear();
+
+    EventIds peleeIds, wcIds;
+    if (!ReadEventIds(pelee, kPeLEEIds, peleeIds)) return false;
+    if (!ReadEventIds(wcChain, kWCIds, wcIds)) return false;
+    if (SameEventOrder(peleeIds, wcIds)) return true;
+
+    std::cout << "WARNING: " << wcPath << " is not entry-aligned with " << pelee->GetName()
+              << ", matching events by run/subrun/event\n";
+
+    entryMap.assign(peleeIds.run.size(), -1);
+    const Long64_t* peleeOffset = pelee->GetTreeOffset();
+    const Long64_t* wcOffset    = wcChain->GetTreeOffset();
+    Long64_t unmatched = 0;
+
+    // Events are only matched within the same input file
+    for (size_t iFile = 0; iFile < files.size(); ++iFile) {
+        TTreeIndex* index = LoadOrBuildIndex(files[iFile], wcPath);
+        if (!index) return false;
+
+        for (Long64_t i = peleeOffset[iFile]; i < peleeOffset[iFile + 1]; ++i) {
+            Long64_t j = index->GetEntryNumberWithIndex(IndexMajor(peleeIds.run[i], peleeIds.subrun[i]),
+                                                        peleeIds.event[i]);
+            if (j < 0) unmatched++;
+            else entryMap[i] = wcOffset[iFile] + j;
+        }
+        delete index;
+    }
+
+    if (unmatched > 0)
+        std::cout << "WARNING: " << unmatched << " " << pelee->GetName() << " entries have no match in "
+                  << wcPath << " and are skipped\n";
+    return true;
+}
+
+#endif
@@ -0,0 +1,142 @@
+// Entry range, batch sharding and data prescale (--first, --count, --shard,
+// --prescale).
+//
+// The event loop used to run over the first half of the entries for data
+// (blinding) and over everything for MC, so a file could neither be split
+// over batch slots nor blinded independently of its entry order. Here the
+// entries [first, first + count) of the chain are cut into nShards contiguous
+// chunks and this process runs chunk `shard`. Inside it, an event is kept if
+// a hash of its (run, subrun, event) falls below the prescale fraction: the
+// same events are kept whatever the file order, range or shard, and a skim
+// made with a prescale passes it again unchanged.
+//
+// Every output file (and the skim) gets the range, shard and prescale it was
+// made with, plus the number of kept events, in its event_range/ directory, so
+// shards can be checked for gaps and overlaps before they are merged.
+
+#ifndef EVENT_RANGE_H
+#define EVENT_RANGE_H
+
+#include <TDirectory.h>
+#include <TNamed.h>
+#include <TParameter.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <initializer_list>
+#include <iostream>
+#include <string>
+
+
+const char* const kEventRangeDir = "event_range";
+
+const double kDataPrescale = 0.5;   // default fraction of data events kept
+
+
+struct EventRangeSettings {
+    Long64_t first = 0;
+    Long64_t count = -1;     // -1: up to the last entry
+    int      shard = 0;
+    int      nShards = 1;
+    double   prescale = -1;  // fraction of events kept, -1: kDataPrescale for data, 1 otherwise
+
+    std::string input;                  // <input_file> argument, to tell the shards of one input apart
+
+    // Set by ResolveEventRange()
+    Long64_t entries = 0;               // entries of the input chain
+    Long64_t begin = 0, end = 0;        // entries run by this process (all workers)
+    Long64_t accepted = 0;              // events of [begin, end) kept by the prescale (summed over workers when merged)
+
+    bool IsDefault() const { return first == 0 && count < 0 && nShards == 1 && prescale < 0; }
+};
+
+inline EventRangeSettings gEventRange;
+
+
+// Non-negative entry number of --first/--count
+inline bool ParseEntryNumber(const std::string& value, const char* option, Long64_t& number) {
+    char* end = nullptr;
+    long long n = std::strtoll(value.c_str(), &end, 10);
+    if (value.empty() || *end != '\0' || n < 0) {
+        std::cerr << "ERROR: " << option << " takes a non-negative entry number, got '" << value << "'\n";
+        return false;
+    }
+    number = n;
+    return true;
+}
+
+// "i/N", 0 <= i < N
+inline bool ParseShard(const std::string& value, EventRangeSettings& range) {
+    char* end = nullptr;
+    long i = std::strtol(value.c_str(), &end, 10);
+    long n = *end == '/' ? std::strtol(end + 1, &end, 10) : 0;
+    if (value.empty() || *end != '\0' || n < 1 || i < 0 || i >= n) {
+        std::cerr << "ERROR: --shard takes i/N with 0 <= i < N, got '" << value << "'\n";
+        return false;
+    }
+    range.shard = i;
+    range.nShards = n;
+    return true;
+}
+
+inline bool ParsePrescale(const std::string& value, double& prescale) {
+    char* end = nullptr;
+    double f = std::strtod(value.c_str(), &end);
+    if (value.empty() || *end != '\0' || !(f > 0 && f <= 1)) {
+        std::cerr << "ERROR: --prescale takes a fraction in (0, 1], got '" << value << "'\n";
+        return false;
+    }
+    prescale = f;
+    return true;
+}
+
+
+// Entries [begin, end) of this shard and the prescale to apply. A skim was
+// already prescaled when it was made, so it is read whole by default.
+inline void ResolveEventRange(Long64_t entries, bool IsData, bool skimInput, EventRangeSettings& range) {
+    range.entries = entries;
+    if (range.prescale < 0) range.prescale = IsData && !skimInput ? kDataPrescale : 1;
+
+    Long64_t first = std::min(range.first, entries);
+    Long64_t last  = range.count < 0 ? entries : std::min(entries, first + range.count);
+    if (range.first > entries)
+        std::cerr << "WARNING: --first " << range.first << " is past the last entry (" << entries << ")\n";
+
+    range.begin = first + (last - first) * range.shard / range.nShards;
+    range.end   = first + (last - first) * (range.shard + 1) / range.nShards;
+    range.accepted = 0;
+}
+
+
+// splitmix64 finalizer
+inline uint64_t MixBits(uint64_t x) {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+// Uniform in [0, 1), a function of the event id only
+inline double PrescaleHash(uint64_t run, uint64_t subrun, uint64_t event) {
+    uint64_t h = MixBits(MixBits(MixBits(run) ^ subrun) ^ event);
+    return (h >> 11) * 0x1.0p-53;
+}
+
+inline bool PassesPrescale(uint64_t run, uint64_t subrun, uint64_t event, double prescale) {
+    return prescale >= 1 || PrescaleHash(run, subrun, event) < prescale;
+}
+
+
+// event_range/ of dir: where the events of this output came from
+inline void WriteEventRange(TDirectory* dir, const EventRangeSettings& range) {
+    TDirectory* out = dir->mkdir(kEventRangeDir);
+    TParameter<Long64_t> entries("entries", range.entries), first("first", range.begin), last("last", range.end),
+                         shard("shard", range.shard), nShards("nshards", range.nShards), accepted("accepted", range.accepted);
+    TParameter<double>   prescale("prescale", range.prescale);
+    TNamed               input("input", range.input.c_str());
+    for (TObject* obj : std::initializer_list<TObject*>{&input, &entries, &first, &last, &shard, &nShards, &accepted, &prescale})
+        out->WriteTObject(obj);
+}
+
+#endif
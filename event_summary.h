@@ -0,0 +1,78 @@
+// Derived quantities of one selected event, computed once.
+//
+// FillEvent used to call Get_Nproton up to three times per event and is_0p
+// once more over the same kine arrays, and kept the blip multiplicities and
+// energy sums in loose locals. An EventSummary holds all of it: the WC proton
+// count and 0p flag and the truth category, which only depend on the branches
+// and are computed once per event for all variants (SummarizeEvent), and the
+// blip counts per population, the blip corrected proton count and the split
+// bits, which depend on the variant (SummarizeBlips). The histograms and
+// counters are then filled from the summary only.
+//
+// Include after the set_vars headers and common_funtions.h.
+
+#ifndef EVENT_SUMMARY_H
+#define EVENT_SUMMARY_H
+
+#include <algorithm>
+
+#include "blip_kernel.h"
+#include "histogram_registry.h"
+#include "truth_category.h"
+
+
+struct EventSummary {
+    // From the branches, the same for every variant
+    int         WC_N_rec_protons = 0;   // Get_Nproton
+    bool        is0p = false;           // is_0p
+    SPCategory  category = kNoSPCategory;
+
+    // From the blips, per variant
+    int   n_blips[kNBlipGroups]    = {0};   // blips per population (kBlipGroups)
+    float SumE_blips[kNBlipGroups] = {0};   // summed in blip order, as a float
+    int   N_rec_protons = 0;                // WC protons, plus the region B signal blips if AddBacktrackedBlips
+    int   splitBits = 0;                    // EventSplitBit
+
+    int   n_sig_all_blips() const      { return n_blips[kSignalAll]; }
+    int   n_sig_all_regB_blips() const { return n_blips[kSignalAllRegB]; }
+    float SumE_sig_all_blips() const   { return SumE_blips[kSignalAll]; }
+};
+
+
+// Truth variables of the current entry
+inline TruthInputs TruthInputsFromBranches() {
+    return { match_completeness_energy, truth_energyInside, truth_single_photon, truth_isCC,
+             truth_NCDelta, truth_vtxInside, truth_showerMother, truth_nuPdg,
+             truth_muonMomentum[3], truth_Npi0 };
+}
+
+// Branch level part of the summary of the current entry
+inline void SummarizeEvent(EventSummary& summary) {
+    summary.WC_N_rec_protons = Get_Nproton(numu_cc_flag, kine_energy_particle, kine_particle_type);
+    summary.is0p             = is_0p(numu_cc_flag, kine_energy_particle, kine_particle_type);
+    summary.category         = ClassifyTruth(TruthInputsFromBranches());
+}
+
+// Blip part of the summary, from the classified blips of one variant
+inline void SummarizeBlips(const BlipBatch& blips, const BlipGeometry& geo, bool AddBacktrackedBlips,
+                           EventSummary& summary) {
+
+    std::fill(summary.n_blips, summary.n_blips + kNBlipGroups, 0);
+    std::fill(summary.SumE_blips, summary.SumE_blips + kNBlipGroups, 0.f);
+
+    for (size_t i = 0; i < blips.n; ++i) {
+        int flags = geo.flags[i];
+        if (!(flags & kBlipSphere)) continue;
+        for (int group = 0; group < kNBlipGroups; ++group) {
+            if ((flags & kBlipGroups[group].mask) != kBlipGroups[group].value) continue;
+            summary.n_blips[group]++;
+            summary.SumE_blips[group] += blips.energy[i];
+        }
+    }
+
+    summary.N_rec_protons = AddBacktrackedBlips ? summary.WC_N_rec_protons + summary.n_sig_all_regB_blips()
+                                                : summary.WC_N_rec_protons;
+    summary.splitBits = EventSplitBits(summary.n_sig_all_blips(), summary.SumE_sig_all_blips(), summary.is0p);
+}
+
+#endif
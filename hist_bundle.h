@@ -0,0 +1,322 @@
+// Flat histogram bundle, next to the ROOT output (--hist-bundle).
+//
+// The plotting macros open every output file and Get ~15 histograms by name
+// from each, which goes through the TKey lookup and the streamer of every
+// object. With --hist-bundle each output file also gets <output>.hbundle.
+// That file holds the same 1D and 2D histograms as plain arrays and can be
+// mmap-ed and read in place:
+//
+//   HistBundleHeader   magic, number of histograms, file size
+//   HistBundleEntry[]  index, sorted by name (path/name inside subdirectories)
+//   names and titles
+//   double arrays      per histogram: bin edges (x, then y), bin contents and
+//                      squared bin errors of all ROOT global bins
+//                      (under/overflow included), 8-byte aligned
+//
+// All offsets are in bytes from the start of the file, in the byte order of
+// the machine that wrote it. HistBundle maps a bundle and gives HistViews
+// (pointers into the mapping, nothing is copied), or a TH1F/TH1D/TH2F/TH2D
+// made from them with Get() for drawing. The ROOT output files are written
+// as before. Bin labels are not kept.
+
+#ifndef HIST_BUNDLE_H
+#define HIST_BUNDLE_H
+
+#include <TDirectory.h>
+#include <TH1.h>
+#include <TH1D.h>
+#include <TH1F.h>
+#include <TH2D.h>
+#include <TH2F.h>
+#include <TKey.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <set>
+#include <string>
+#include <string_view>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+
+inline bool gWriteHistBundle = false;   // --hist-bundle
+
+const char kHistBundleMagic[8] = {'H', 'B', 'U', 'N', 'D', 'L', 'E', '1'};
+
+struct HistBundleHeader {
+    char     magic[8];
+    uint64_t nHists;
+    uint64_t indexOffset;
+    uint64_t fileSize;
+};
+
+struct HistBundleEntry {
+    uint64_t nameOffset, titleOffset;
+    uint32_t nameLength, titleLength;     // title: "title;x axis;y axis"
+    uint32_t dimension;                   // 1 or 2
+    uint32_t nx, ny;                      // bins, without under/overflow (ny = 1 for 1D)
+    uint32_t ncells;                      // (nx + 2) (ny + 2) global bins
+    char     type;                        // 'F' or 'D' (TH1F/TH2F or TH1D/TH2D)
+    char     pad[7];
+    uint64_t edgesOffset;                 // nx + 1 x edges, then ny + 1 y edges for 2D
+    uint64_t contentOffset;               // ncells bin contents
+    uint64_t sumw2Offset;                 // ncells squared bin errors
+    double   entries;
+};
+
+
+// --- Writer ---
+
+inline std::string BundleBaseName(const std::string& rootFile) {
+    std::string base = rootFile;
+    if (base.size() > 5 && base.compare(base.size() - 5, 5, ".root") == 0) base.resize(base.size() - 5);
+    return base + ".hbundle";
+}
+
+// The TH1 of dir and its subdirectories, as path/name. The ones not in
+// memory are read from the file and kept in `read`, to be deleted with it.
+inline void CollectBundleHists(TDirectory* dir, const std::string& prefix, std::vector<std::pair<std::string, TH1*>>& hists,
+                               std::vector<std::unique_ptr<TObject>>& read) {
+    std::set<std::string> seen;   // keys come highest cycle first
+    TIter next(dir->GetListOfKeys());
+    while (TKey* key = (TKey*)next()) {
+        std::string name = key->GetName();
+        if (!seen.insert(name).second) continue;
+        if (std::string(key->GetClassName()) == "TDirectoryFile") {
+            CollectBundleHists(dir->GetDirectory(name.c_str()), prefix + name + "/", hists, read);
+            continue;
+        }
+        TObject* obj = dir->GetList()->FindObject(name.c_str());
+        if (!obj) {
+            obj = key->ReadObj();
+            if (!obj) continue;
+            read.emplace_back(obj);
+        }
+        if (obj->InheritsFrom("TH1")) hists.emplace_back(prefix + name, (TH1*)obj);
+    }
+}
+
+// Bundle of the histograms of dir (written to disk already)
+inline bool WriteHistBundle(const std::string& path, TDirectory* dir) {
+
+    std::vector<std::pair<std::string, TH1*>> hists;
+    std::vector<std::unique_ptr<TObject>> read;
+    CollectBundleHists(dir, "", hists, read);
+    hists.erase(std::remove_if(hists.begin(), hists.end(), [](const std::pair<std::string, TH1*>& h) {
+                    if (h.second->GetDimension() <= 2) return false;
+                    std::cerr << "WARNING: " << h.first << " has more than 2 dimensions, not in the histogram bundle\n";
+                    return true;
+                }), hists.end());
+    std::sort(hists.begin(), hists.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    std::vector<HistBundleEntry> index(hists.size());
+    std::string strings;
+    std::vector<double> data;
+    for (size_t i = 0; i < hists.size(); ++i) {
+        const TH1* h = hists[i].second;
+        HistBundleEntry& e = index[i];
+        std::memset(&e, 0, sizeof(e));
+        std::string title = std::string(h->GetTitle()) + ";" + h->GetXaxis()->GetTitle() + ";" + h->GetYaxis()->GetTitle();
+        e.nameOffset  = strings.size();
+        e.nameLength  = hists[i].first.size();
+        strings += hists[i].first;
+        e.titleOffset = strings.size();
+        e.titleLength = title.size();
+        strings += title;
+        e.dimension = h->GetDimension();
+        e.nx        = h->GetNbinsX();
+        e.ny        = e.dimension == 2 ? h->GetNbinsY() : 1;
+        e.ncells    = h->GetNcells();
+        e.type      = h->InheritsFrom("TH1D") || h->InheritsFrom("TH2D") ? 'D' : 'F';
+        e.entries   = h->GetEntries();
+
+        // Offsets inside the data block for now
+        e.edgesOffset = data.size() * sizeof(double);
+        for (uint32_t bin = 1; bin <= e.nx + 1; ++bin) data.push_back(h->GetXaxis()->GetBinLowEdge(bin));
+        if (e.dimension == 2)
+            for (uint32_t bin = 1; bin <= e.ny + 1; ++bin) data.push_back(h->GetYaxis()->GetBinLowEdge(bin));
+        e.contentOffset = data.size() * sizeof(double);
+        for (uint32_t bin = 0; bin < e.ncells; ++bin) data.push_back(h->GetBinContent(bin));
+        e.sumw2Offset = data.size() * sizeof(double);
+        for (uint32_t bin = 0; bin < e.ncells; ++bin) data.push_back(std::pow(h->GetBinError(bin), 2));
+    }
+
+    HistBundleHeader header;
+    std::memcpy(header.magic, kHistBundleMagic, sizeof(header.magic));
+    header.nHists = index.size();
+    header.indexOffset = sizeof(HistBundleHeader);
+    uint64_t stringsOffset = header.indexOffset + index.size() * sizeof(HistBundleEntry);
+    uint64_t dataOffset = (stringsOffset + strings.size() + 7) / 8 * 8;
+    header.fileSize = dataOffset + data.size() * sizeof(double);
+    for (HistBundleEntry& e : index) {
+        e.nameOffset    += stringsOffset;
+        e.titleOffset   += stringsOffset;
+        e.edgesOffset   += dataOffset;
+        e.contentOffset += dataOffset;
+        e.sumw2Offset   += dataOffset;
+    }
+
+    std::ofstream out(path, std::ios::binary);
+    out.write((const char*)&header, sizeof(header));
+    out.write((const char*)index.data(), index.size() * sizeof(HistBundleEntry));
+    out.write(strings.data(), strings.size());
+    out.write(std::string(dataOffset - stringsOffset - strings.size(), '\0').data(), dataOffset - stringsOffset - strings.size());
+    out.write((const char*)data.data(), data.size() * sizeof(double));
+    if (!out) {
+        std::cerr << "WARNING: could not write the histogram bundle " << path << "\n";
+        return false;
+    }
+    return true;
+}
+
+
+// --- Reader ---
+
+// One histogram of a mapped bundle; the pointers are valid while the bundle is open
+struct HistView {
+    std::string name, title;
+    int dimension = 0, nx = 0, ny = 0, ncells = 0;
+    char type = 'F';
+    double entries = 0;
+    const double* edgesX = nullptr;
+    const double* edgesY = nullptr;   // 2D only
+    const double* content = nullptr;  // global bins, as TH1::GetBin()
+    const double* sumw2 = nullptr;
+};
+
+class HistBundle {
+public:
+    HistBundle() {}
+    explicit HistBundle(const std::string& path) { Open(path); }
+    ~HistBundle() { Close(); }
+    HistBundle(const HistBundle&) = delete;
+    HistBundle& operator=(const HistBundle&) = delete;
+
+    bool Open(const std::string& path) {
+        Close();
+        int fd = open(path.c_str(), O_RDONLY);
+        struct stat st;
+        if (fd < 0 || fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(HistBundleHeader)) {
+            if (fd >= 0) close(fd);
+            std::cerr << "ERROR: cannot open the histogram bundle " << path << "\n";
+            return false;
+        }
+        void* map = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        close(fd);   // the mapping stays
+        if (map == MAP_FAILED) {
+            std::cerr << "ERROR: cannot map the histogram bundle " << path << "\n";
+            return false;
+        }
+        fData = (const char*)map;
+        fSize = st.st_size;
+        const HistBundleHeader* header = (const HistBundleHeader*)fData;
+        if (std::memcmp(header->magic, kHistBundleMagic, sizeof(kHistBundleMagic)) != 0 || header->fileSize != fSize ||
+            header->indexOffset + header->nHists * sizeof(HistBundleEntry) > fSize) {
+            std::cerr << "ERROR: " << path << " is not a histogram bundle of this version, or is truncated\n";
+            Close();
+            return false;
+        }
+        fIndex = (const HistBundleEntry*)(fData + header->indexOffset);
+        fNHists = header->nHists;
+        for (size_t i = 0; i < fNHists; ++i) {
+            const HistBundleEntry& e = fIndex[i];
+            uint64_t nEdges = e.nx + 1 + (e.dimension == 2 ? e.ny + 1 : 0);
+            if (e.nameOffset + e.nameLength > fSize || e.titleOffset + e.titleLength > fSize ||
+                e.edgesOffset + nEdges * sizeof(double) > fSize || e.contentOffset + e.ncells * sizeof(double) > fSize ||
+                e.sumw2Offset + e.ncells * sizeof(double) > fSize) {
+                std::cerr << "ERROR: " << path << " is corrupted (histogram " << i << ")\n";
+                Close();
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void Close() {
+        if (fData) munmap((void*)fData, fSize);
+        fData = nullptr;
+        fSize = 0;
+        fIndex = nullptr;
+        fNHists = 0;
+    }
+
+    bool IsOpen() const { return fData != nullptr; }
+    size_t Size() const { return fNHists; }
+    std::string_view Name(size_t i) const { return std::string_view(fData + fIndex[i].nameOffset, fIndex[i].nameLength); }
+
+    // Binary search of the sorted index
+    bool Find(const std::string& name, HistView& view) const {
+        size_t lo = 0, hi = fNHists;
+        while (lo < hi) {
+            size_t mid = (lo + hi) / 2;
+            int cmp = Name(mid).compare(name);
+            if (cmp == 0) {
+                Fill(fIndex[mid], view);
+                return true;
+            }
+            if (cmp < 0) lo = mid + 1;
+            else hi = mid;
+        }
+        return false;
+    }
+
+    // New histogram (owned by the caller, in no directory) with the contents
+    // of `name`, like TFile::Get. nullptr if it is not in the bundle.
+    TH1* Get(const std::string& name) const {
+        HistView view;
+        if (!Find(name, view)) return nullptr;
+        return MakeHist(view);
+    }
+
+    static TH1* MakeHist(const HistView& view) {
+        std::string name = view.name.substr(view.name.rfind('/') + 1);
+        TH1* h = nullptr;
+        if (view.dimension == 2 && view.type == 'D')
+            h = new TH2D(name.c_str(), view.title.c_str(), view.nx, view.edgesX, view.ny, view.edgesY);
+        else if (view.dimension == 2)
+            h = new TH2F(name.c_str(), view.title.c_str(), view.nx, view.edgesX, view.ny, view.edgesY);
+        else if (view.type == 'D')
+            h = new TH1D(name.c_str(), view.title.c_str(), view.nx, view.edgesX);
+        else
+            h = new TH1F(name.c_str(), view.title.c_str(), view.nx, view.edgesX);
+        h->SetDirectory(nullptr);
+        h->Sumw2();
+        for (int bin = 0; bin < view.ncells; ++bin) {
+            h->SetBinContent(bin, view.content[bin]);
+            h->SetBinError(bin, std::sqrt(view.sumw2[bin]));
+        }
+        h->SetEntries(view.entries);
+        return h;
+    }
+
+private:
+    void Fill(const HistBundleEntry& e, HistView& view) const {
+        view.name      = std::string(fData + e.nameOffset, e.nameLength);
+        view.title     = std::string(fData + e.titleOffset, e.titleLength);
+        view.dimension = e.dimension;
+        view.nx        = e.nx;
+        view.ny        = e.ny;
+        view.ncells    = e.ncells;
+        view.type      = e.type;
+        view.entries   = e.entries;
+        view.edgesX    = (const double*)(fData + e.edgesOffset);
+        view.edgesY    = e.dimension == 2 ? view.edgesX + e.nx + 1 : nullptr;
+        view.content   = (const double*)(fData + e.contentOffset);
+        view.sumw2     = (const double*)(fData + e.sumw2Offset);
+    }
+
+    const char* fData = nullptr;
+    size_t fSize = 0;
+    const HistBundleEntry* fIndex = nullptr;
+    size_t fNHists = 0;
+};
+
+#endif
@@ -0,0 +1,190 @@
+// Histograms of one selection pass, generated from tables.
+//
+// The output histograms used to be declared one by one (several hundred TH1F
+// members) and filled through copy-pasted ->Fill blocks. Here they are built
+// from tables:
+//   - blips: population (kBlipGroups: sphere/signal, region A/B, MC/overlay,
+//     truth class) x variable (kBlipVarAxes: energy, dist2vtx, angle, cosangle)
+//   - events: truth category (kSPCategoryNames) x split (all, 0n, Nn, 0p, Np),
+//     plus the number of protons, blip multiplicity and summed blip energy
+// and kept in one array, addressed by the index functions below, so a fill is
+// an array access instead of a member lookup. Names, titles, binning and the
+// order they are written in are those of the hand-declared histograms, so the
+// output files and the plotting macros are unchanged.
+//
+// A new blip population only needs a row in kBlipGroups.
+
+#ifndef HISTOGRAM_REGISTRY_H
+#define HISTOGRAM_REGISTRY_H
+
+#include <TDirectory.h>
+#include <TH1F.h>
+#include <TH2F.h>
+
+#include <string>
+#include <vector>
+
+#include "blip_kernel.h"
+#include "truth_category.h"
+
+
+// --- Blip populations ---
+
+enum BlipVar { kBlipEnergy = 0, kBlipDist2vtx, kBlipAngle, kBlipCosangle, kNBlipVars };
+
+struct HistAxis {
+    const char* title;
+    int nbins;
+    double min, max;
+};
+
+const char* const kBlipVars[kNBlipVars] = {"energy", "dist2vtx", "angle", "cosangle"};
+
+const HistAxis kBlipVarAxes[kNBlipVars] = {
+    {"Blip energy [MeV_{ee}]",               100,  0,  50},
+    {"Blip distance to shower vertex [cm]",  160,  0, 800},
+    {"#alpha [degrees]",                      36,  0, 180},
+    {"Cos(#alpha)",                          800, -1,   1},
+};
+
+
+// One h_Blip_* population: blips whose flags & mask == value. The histogram
+// of variable <var> is "h_Blip_" + prefix + var + suffix, titled
+// label + " ; " + axis + "; Counts".
+struct BlipGroup {
+    const char* prefix;
+    const char* suffix;
+    const char* label;
+    int mask;
+    int value;
+};
+
+enum BlipGroupId {
+    kSphereAll = 0, kSphereMC, kSphereMC_p, kSphereMC_e, kSphereMC_HN, kSphereMC_other, kSphereOver,
+    kSignalAll, kSignalAllRegA, kSignalAllRegB,
+    kSignalMC, kSignalMC_p, kSignalMC_e, kSignalMC_HN, kSignalMC_other,
+    kSignalMCRegA, kSignalMCRegA_p, kSignalMCRegA_e, kSignalMCRegA_HN, kSignalMCRegA_other,
+    kSignalMCRegB, kSignalMCRegB_p, kSignalMCRegB_e, kSignalMCRegB_HN, kSignalMCRegB_other,
+    kSignalOver, kSignalOverRegA, kSignalOverRegB,
+    kNBlipGroups
+};
+
+const int kMCTruth = kBlipMC | kBlipTruthMask;
+
+const BlipGroup kBlipGroups[kNBlipGroups] = {
+    {"sphere_all_",       "",          "All sphere blips",            kBlipSphere,                         kBlipSphere},
+    {"sphere_all_",       "_mc",       "MC sphere blips",             kBlipSphere | kBlipMC,               kBlipSphere | kBlipMC},
+    {"sphere_all_",       "_mc_p",     " MC-p sphere blips",          kBlipSphere | kMCTruth,              kBlipSphere | kBlipMC | (kBlipTruthProton << kBlipTruthBit)},
+    {"sphere_all_",       "_mc_e",     " MC-e sphere blips",          kBlipSphere | kMCTruth,              kBlipSphere | kBlipMC | (kBlipTruthElectron << kBlipTruthBit)},
+    {"sphere_all_",       "_mc_HN",    " MC-HN sphere blips",         kBlipSphere | kMCTruth,              kBlipSphere | kBlipMC | (kBlipTruthHeavyNucleus << kBlipTruthBit)},
+    {"sphere_all_",       "_mc_other", " MC-other sphere blips",      kBlipSphere | kMCTruth,              kBlipSphere | kBlipMC | (kBlipTruthOther << kBlipTruthBit)},
+    {"sphere_all_",       "_over",     "All sphere blips",            kBlipSphere | kBlipMC,               kBlipSphere},
+
+    {"signal_all_",       "",          "All signal blips",            kBlipSignal,                         kBlipSignal},
+    {"signal_all_regA_",  "",          "All regA signal blips",       kBlipSignal | kBlipRegB,             kBlipSignal},
+    {"signal_all_regB_",  "",          "All regB signal blips",       kBlipSignal | kBlipRegB,             kBlipSignal | kBlipRegB},
+
+    {"signal_mc_",        "",          "MC signal blips",             kBlipSignal | kBlipMC,               kBlipSignal | kBlipMC},
+    {"signal_mc_",        "_p",        "MC-p signal blips",           kBlipSignal | kMCTruth,              kBlipSignal | kBlipMC | (kBlipTruthProton << kBlipTruthBit)},
+    {"signal_mc_",        "_e",        " MC-e signal blips",          kBlipSignal | kMCTruth,              kBlipSignal | kBlipMC | (kBlipTruthElectron << kBlipTruthBit)},
+    {"signal_mc_",        "_HN",       " MC-HN signal blips",         kBlipSignal | kMCTruth,              kBlipSignal | kBlipMC | (kBlipTruthHeavyNucleus << kBlipTruthBit)},
+    {"signal_mc_",        "_other",    " MC-other signal blips",      kBlipSignal | kMCTruth,              kBlipSignal | kBlipMC | (kBlipTruthOther << kBlipTruthBit)},
+
+    {"signal_mc_regA_",   "",          "MC regA signal blips",        kBlipSignal | kBlipRegB | kBlipMC,   kBlipSignal | kBlipMC},
+    {"signal_mc_regA_",   "_p",        "MC regA-p signal blips",      kBlipSignal | kBlipRegB | kMCTruth,  kBlipSignal | kBlipMC | (kBlipTruthProton << kBlipTruthBit)},
+    {"signal_mc_regA_",   "_e",        " MC regA-e signal blips",     kBlipSignal | kBlipRegB | kMCTruth,  kBlipSignal | kBlipMC | (kBlipTruthElectron << kBlipTruthBit)},
+    {"signal_mc_regA_",   "_HN",       " MC regA-HN signal blips",    kBlipSignal | kBlipRegB | kMCTruth,  kBlipSignal | kBlipMC | (kBlipTruthHeavyNucleus << kBlipTruthBit)},
+    {"signal_mc_regA_",   "_other",    " MC regA-other signal blips", kBlipSignal | kBlipRegB | kMCTruth,  kBlipSignal | kBlipMC | (kBlipTruthOther << kBlipTruthBit)},
+
+    {"signal_mc_regB_",   "",          "MC regB signal blips",        kBlipSignal | kBlipRegB | kBlipMC,   kBlipSignal | kBlipRegB | kBlipMC},
+    {"signal_mc_regB_",   "_p",        "MC regB-p signal blips",      kBlipSignal | kBlipRegB | kMCTruth,  kBlipSignal | kBlipRegB | kBlipMC | (kBlipTruthProton << kBlipTruthBit)},
+    {"signal_mc_regB_",   "_e",        " MC regB-e signal blips",     kBlipSignal | kBlipRegB | kMCTruth,  kBlipSignal | kBlipRegB | kBlipMC | (kBlipTruthElectron << kBlipTruthBit)},
+    {"signal_mc_regB_",   "_HN",       " MC regB-HN signal blips",    kBlipSignal | kBlipRegB | kMCTruth,  kBlipSignal | kBlipRegB | kBlipMC | (kBlipTruthHeavyNucleus << kBlipTruthBit)},
+    {"signal_mc_regB_",   "_other",    " MC regB-other signal blips", kBlipSignal | kBlipRegB | kMCTruth,  kBlipSignal | kBlipRegB | kBlipMC | (kBlipTruthOther << kBlipTruthBit)},
+
+    {"signal_over_",      "",          "Overlay signal blips",        kBlipSignal | kBlipMC,               kBlipSignal},
+    {"signal_over_regA_", "",          "Overlay regA signal blips",   kBlipSignal | kBlipRegB | kBlipMC,   kBlipSignal},
+    {"signal_over_regB_", "",          "Overlay regB signal blips",   kBlipSignal | kBlipRegB | kBlipMC,   kBlipSignal | kBlipRegB},
+};
+
+
+// --- Event histograms ---
+
+// Truth categories: truth_category.h
+
+// Event splits: blip based 0n/Nn and WC proton based 0p/Np
+enum EventSplit { kSplitAll = 0, kSplit0n, kSplitNn, kSplit0p, kSplitNp, kNSplits };
+
+const char* const kSplitSuffix[kNSplits] = {"", "_0n", "_Nn", "_0p", "_Np"};
+
+
+// Index of every histogram in HistogramRegistry. Not every split exists for
+// every histogram (e.g. no h_1gX_Nprotons_0p); those slots stay empty.
+inline int NprotonsHist(int split)                    { return split; }
+inline int SPHist(int category, int split)            { return kNSplits + split * kNSPCategories + category; }
+inline int BlipMultiplicityHist(int split)            { return kNSplits * (1 + kNSPCategories) + split; }
+inline int SumEblipHist(int split)                    { return kNSplits * (2 + kNSPCategories) + split; }
+inline int MultiplicitySumEHist(int split)            { return kNSplits * (3 + kNSPCategories) + split; }
+inline int BlipHist(int group, int var)               { return kNSplits * (4 + kNSPCategories) + group * kNBlipVars + var; }
+const int kNHists = BlipHist(kNBlipGroups, 0);
+
+
+class HistogramRegistry {
+public:
+
+    // Creates every histogram in the current directory, in the order of the
+    // hand-declared histograms
+    void Book() {
+
+        fHists.assign(kNHists, nullptr);
+
+        const char* nprotonsTitle[] = {"", " - 0n", " - Nn"};
+        for (int split : {kSplitAll, kSplit0n, kSplitNn})
+            Book1D(NprotonsHist(split), std::string("h_1gX_Nprotons") + kSplitSuffix[split],
+                   std::string("Inclusive single shower selection") + nprotonsTitle[split] + "; Number of Protons; Events",
+                   10, 0, 10);
+
+        // 0p/Np only for the signal categories
+        for (int split = 0; split < kNSplits; ++split) {
+            std::string title = std::string("Inclusive 1g signal events") +
+                                (split == kSplit0n ? " - 0n" : split == kSplitNn ? " - Nn" : "") +
+                                ";Number of Protons; Event counts";
+            int ncategories = (split == kSplit0p || split == kSplitNp) ? kNSPSignalCategories : kNSPCategories;
+            for (int category = 0; category < ncategories; ++category)
+                Book1D(SPHist(category, split),
+                       std::string("h_") + kSPCategoryNames[category] + "_Nprotons" + kSplitSuffix[split], title, 10, 0, 10);
+        }
+
+        for (int split : {kSplitAll, kSplit0p, kSplitNp}) {
+            Book1D(BlipMultiplicityHist(split), std::string("h_1gX_BlipMultiplicity") + kSplitSuffix[split],
+                   "Inclusive 1g signal events; Blip multiplicity ; counts", 100, 0, 100);
+            Book1D(SumEblipHist(split), std::string("h_1gX_SumEblip") + kSplitSuffix[split],
+                   "Inclusive 1g signal events; Summed blip energy [MeV_{ee}]; Counts", 100, 0, 100);
+        }
+        for (int split : {kSplitAll, kSplit0p, kSplitNp})
+            fHists[MultiplicitySumEHist(split)] =
+                new TH2F((std::string("h2D_1gX_BlipMultiplicity_SumEblip") + kSplitSuffix[split]).c_str(),
+                         "Inclusive 1g signal events; Blip multiplicity ; Sum E blip", 100, 0, 100, 100, 0, 100);
+
+        for (int group = 0; group < kNBlipGroups; ++group)
+            for (int var = 0; var < kNBlipVars; ++var)
+                Book1D(BlipHist(group, var),
+                       std::string("h_Blip_") + kBlipGroups[group].prefix + kBlipVars[var] + kBlipGroups[group].suffix,
+                       std::string(kBlipGroups[group].label) + " ; " + kBlipVarAxes[var].title + "; Counts",
+                       kBlipVarAxes[var].nbins, kBlipVarAxes[var].min, kBlipVarAxes[var].max);
+    }
+
+    TH1*  operator[](int index) const { return fHists[index]; }
+    TH2F* Hist2D(int index) const { return (TH2F*)fHists[index]; }
+
+    void Fill(int index, double x) { fHists[index]->Fill(x); }
+
+private:
+    std::vector<TH1*> fHists;   // owned by the output file
+
+    void Book1D(int index, const std::string& name, const std::string& title, int nbins, double min, double max) {
+        fHists[index] = new TH1F(name.c_str(), title.c_str(), nbins, min, max);
+    }
+};
+
+#endif
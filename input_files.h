@@ -0,0 +1,89 @@
+// Input file lists for the 1gX selection.
+//
+// The <input_file> argument can be a single reco2 file, a glob (quote it so
+// the shell does not expand it), or a text file with one ROOT file per line
+// (.list or .txt, blank lines and lines starting with # are skipped).
+// Every file is added to the same five chains, so the entries of the chains
+// stay aligned as long as they are aligned inside each file.
+
+#ifndef INPUT_FILES_H
+#define INPUT_FILES_H
+
+#include <glob.h>
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+
+inline bool IsInputList(const std::string& spec) {
+    auto endsWith = [&](const std::string& ext) {
+        return spec.size() > ext.size() && spec.compare(spec.size() - ext.size(), ext.size(), ext) == 0;
+    };
+    return endsWith(".list") || endsWith(".txt");
+}
+
+inline bool IsInputGlob(const std::string& spec) {
+    return spec.find_first_of("*?[") != std::string::npos;
+}
+
+
+// Expands the <input_file> argument into the list of ROOT files, in the order
+// they are chained. Returns an empty list (after printing why) on error.
+inline std::vector<std::string> ExpandInputFiles(const std::string& spec) {
+
+    std::vector<std::string> files;
+
+    if (IsInputList(spec)) {
+        std::ifstream list(spec);
+        if (!list) {
+            std::cerr << "ERROR: Could not open input file list " << spec << "\n";
+            return files;
+        }
+        std::string line;
+        while (std::getline(list, line)) {
+            line.erase(0, line.find_first_not_of(" \t"));
+            line.erase(line.find_last_not_of(" \t\r") + 1);
+            if (line.empty() || line[0] == '#') continue;
+            files.push_back(line);
+        }
+    } else if (IsInputGlob(spec)) {
+        glob_t matches;
+        if (glob(spec.c_str(), 0, nullptr, &matches) == 0)
+            for (size_t i = 0; i < matches.gl_pathc; ++i) files.push_back(matches.gl_pathv[i]);
+        globfree(&matches);
+        std::sort(files.begin(), files.end());
+    } else {
+        files.push_back(spec);
+    }
+
+    if (files.empty())
+        std::cerr << "ERROR: No input files match " << spec << "\n";
+    return files;
+}
+
+
+// Name the output files are built from: the file name without path and
+// extension, with any wildcard characters of a glob dropped
+// (e.g. "MCnu_run4b_*.root" -> "MCnu_run4b", "samples.list" -> "samples").
+inline std::string InputBaseName(const std::string& spec) {
+
+    size_t slash = spec.find_last_of("/\\");
+    std::string name = (slash == std::string::npos) ? spec : spec.substr(slash + 1);
+
+    size_t dot = name.find_last_of(".");
+    if (dot != std::string::npos) name = name.substr(0, dot);
+
+    if (IsInputGlob(name)) {
+        name.erase(std::remove_if(name.begin(), name.end(),
+                                  [](char c) { return c == '*' || c == '?' || c == '[' || c == ']'; }),
+                   name.end());
+        while (!name.empty() && (name.back() == '_' || name.back() == '-' || name.back() == '.')) name.pop_back();
+        if (name.empty()) name = "chain";
+    }
+    return name;
+}
+
+#endif
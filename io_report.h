@@ -0,0 +1,196 @@
+// I/O report of the event loop (--io-report).
+//
+// Whether a run is limited by reading the input or by the selection itself
+// was guesswork. With --io-report a TTreePerfStats is attached to each input
+// tree (PeLEE, T_PFeval, T_KINEvars, T_BDTvars, T_eval; the skim tree once)
+// for the compressed bytes, read calls and unzip time, and every GetEntry of
+// the loop is timed per tree (InputTree::readSeconds). Together with the real
+// and CPU time of the job they are printed at the end and written as JSON to
+// <output>.io.json next to every output file, to compare throughput between
+// software releases. With --threads the numbers are summed over the workers,
+// except the real time, which is the parent's.
+
+#ifndef IO_REPORT_H
+#define IO_REPORT_H
+
+#include <TDirectory.h>
+#include <TParameter.h>
+#include <TROOT.h>
+#include <TStopwatch.h>
+#include <TString.h>
+#include <TTreePerfStats.h>
+
+#include <algorithm>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "branch_manifest.h"
+
+
+// One input tree, summed over the workers
+struct TreeIOStats {
+    bool     perfStats = false;   // has its own TTreePerfStats (not the skim tree seen again)
+    Long64_t entries = 0;         // entries read (preselection or all branches)
+    Long64_t bytesRead = 0;       // compressed, from the file
+    Long64_t readCalls = 0;
+    double   unzipSeconds = 0;
+    double   readSeconds = 0;     // wall time in GetEntry
+    double   realSeconds = 0;     // TTreePerfStats: from the start of the loop to its end
+    double   cpuSeconds = 0;
+};
+
+struct IOReportSettings {
+    bool enabled = false;
+    std::vector<TreeIOStats> trees;   // one per InputTree
+    double cpuSeconds = 0;            // loop of this process and its workers
+    double realSeconds = 0;           // loop of this process
+    TStopwatch watch;
+    std::vector<std::unique_ptr<TTreePerfStats>> perfStats;   // this process, null if the tree is already watched
+};
+
+inline IOReportSettings gIOReport;
+
+
+// Before the event loop of a process (main or worker). perfStats: attach
+// the TTreePerfStats (the trees are read by this process)
+inline void StartIOReport(std::vector<InputTree>& inputs, bool perfStats) {
+    gIOReport.trees.resize(inputs.size());
+    gIOReport.perfStats.clear();
+    for (size_t k = 0; k < inputs.size(); ++k) {
+        InputTree& in = inputs[k];
+        bool watched = false;
+        for (size_t j = 0; j < k; ++j) watched = watched || inputs[j].tree == in.tree;
+        in.timed = true;
+        gIOReport.perfStats.emplace_back(perfStats && !watched ? new TTreePerfStats(Form("ioperf_%zu", k), in.tree) : nullptr);
+    }
+    gIOReport.watch.Start();
+}
+
+// After the event loop of a process: adds its numbers
+inline void StopIOReport(std::vector<InputTree>& inputs) {
+    gIOReport.watch.Stop();
+    gIOReport.realSeconds += gIOReport.watch.RealTime();
+    gIOReport.cpuSeconds  += gIOReport.watch.CpuTime();
+    for (size_t k = 0; k < inputs.size(); ++k) {
+        TreeIOStats& stats = gIOReport.trees[k];
+        stats.entries     += inputs[k].entriesRead;
+        stats.readSeconds += inputs[k].readSeconds;
+        inputs[k].entriesRead = 0;
+        inputs[k].readSeconds = 0;
+        TTreePerfStats* perf = k < gIOReport.perfStats.size() ? gIOReport.perfStats[k].get() : nullptr;
+        if (!perf) continue;
+        perf->Finish();
+        stats.perfStats     = true;
+        stats.bytesRead    += perf->GetBytesRead();
+        stats.readCalls    += perf->GetReadCalls();
+        stats.unzipSeconds += perf->GetUnzipTime();
+        stats.realSeconds  += perf->GetRealTime();
+        stats.cpuSeconds   += perf->GetCpuTime();
+        inputs[k].tree->SetPerfStats(nullptr);
+    }
+    gIOReport.perfStats.clear();
+}
+
+
+// Worker shard io/ directory
+inline void WriteIOStats(TDirectory* io) {
+    io->cd();
+    TParameter<double>("ioCpuSeconds", gIOReport.cpuSeconds).Write();
+    for (size_t k = 0; k < gIOReport.trees.size(); ++k) {
+        const TreeIOStats& s = gIOReport.trees[k];
+        TParameter<Long64_t>(Form("ioPerfStats_%zu", k), s.perfStats).Write();
+        TParameter<Long64_t>(Form("ioEntries_%zu", k), s.entries).Write();
+        TParameter<Long64_t>(Form("ioBytesRead_%zu", k), s.bytesRead).Write();
+        TParameter<Long64_t>(Form("ioReadCalls_%zu", k), s.readCalls).Write();
+        TParameter<double>(Form("ioUnzipSeconds_%zu", k), s.unzipSeconds).Write();
+        TParameter<double>(Form("ioReadSeconds_%zu", k), s.readSeconds).Write();
+        TParameter<double>(Form("ioRealSeconds_%zu", k), s.realSeconds).Write();
+        TParameter<double>(Form("ioCpuSeconds_%zu", k), s.cpuSeconds).Write();
+    }
+}
+
+inline void MergeIOStats(TDirectory* io) {
+    auto add = [io](const char* name, auto& value) {
+        TParameter<std::remove_reference_t<decltype(value)>>* p = nullptr;
+        io->GetObject(name, p);
+        if (p) value += p->GetVal();
+    };
+    add("ioCpuSeconds", gIOReport.cpuSeconds);
+    for (size_t k = 0; k < gIOReport.trees.size(); ++k) {
+        TreeIOStats& s = gIOReport.trees[k];
+        Long64_t perfStats = 0;
+        add(Form("ioPerfStats_%zu", k), perfStats);
+        s.perfStats = s.perfStats || perfStats;
+        add(Form("ioEntries_%zu", k), s.entries);
+        add(Form("ioBytesRead_%zu", k), s.bytesRead);
+        add(Form("ioReadCalls_%zu", k), s.readCalls);
+        add(Form("ioUnzipSeconds_%zu", k), s.unzipSeconds);
+        add(Form("ioReadSeconds_%zu", k), s.readSeconds);
+        add(Form("ioRealSeconds_%zu", k), s.realSeconds);
+        add(Form("ioCpuSeconds_%zu", k), s.cpuSeconds);
+    }
+}
+
+
+// events: entries the loop ran over; unzipped bytes from InputTree::bytesRead
+inline void PrintIOReport(const std::vector<InputTree>& inputs, Long64_t events) {
+    std::cout << "\n ---- I/O REPORT ----\n";
+    for (size_t k = 0; k < inputs.size(); ++k) {
+        const TreeIOStats& s = gIOReport.trees[k];
+        std::cout << " " << std::left << std::setw(38) << inputs[k].path
+                  << " read " << std::setw(9) << s.readSeconds << " s";
+        if (s.perfStats)
+            std::cout << "  unzip " << std::setw(9) << s.unzipSeconds << " s  " << s.bytesRead << " bytes in "
+                      << s.readCalls << " calls";
+        std::cout << "\n";
+    }
+    std::cout << " Real " << gIOReport.realSeconds << " s, CPU " << gIOReport.cpuSeconds << " s, "
+              << (gIOReport.realSeconds > 0 ? events / gIOReport.realSeconds : 0) << " events/s\n";
+    std::cout << " --------------------\n";
+}
+
+inline bool WriteIOReport(const std::string& path, const std::string& input, const std::vector<InputTree>& inputs,
+                          Long64_t events, Long64_t payloadEvents, Long64_t fileBytesRead, int nWorkers) {
+    std::ofstream out(path);
+    if (!out) {
+        std::cerr << "WARNING: could not write the I/O report to " << path << "\n";
+        return false;
+    }
+    char date[32];
+    std::time_t now = std::time(nullptr);
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+    double real = gIOReport.realSeconds, cpu = gIOReport.cpuSeconds;
+
+    out << "{\n  \"input\": \"" << input << "\",\n"
+        << "  \"date\": \"" << date << "\",\n"
+        << "  \"root_version\": \"" << gROOT->GetVersion() << "\",\n"
+        << "  \"workers\": " << nWorkers << ",\n"
+        << "  \"entries\": " << events << ",\n"
+        << "  \"payload_entries\": " << payloadEvents << ",\n"
+        << "  \"file_bytes_read\": " << fileBytesRead << ",\n"
+        << "  \"real_s\": " << real << ",\n"
+        << "  \"cpu_s\": " << cpu << ",\n"
+        << "  \"cpu_over_real\": " << (real > 0 ? cpu / real : 0) << ",\n"
+        << "  \"events_per_s\": " << (real > 0 ? events / real : 0) << ",\n"
+        << "  \"trees\": [\n";
+    for (size_t k = 0; k < inputs.size(); ++k) {
+        const TreeIOStats& s = gIOReport.trees[k];
+        out << "    {\"tree\": \"" << inputs[k].path << "\", \"perf_stats\": " << (s.perfStats ? "true" : "false")
+            << ", \"entries_read\": " << s.entries << ", \"unzipped_bytes\": " << inputs[k].bytesRead
+            << ", \"bytes_read\": " << s.bytesRead << ", \"read_calls\": " << s.readCalls
+            << ", \"unzip_s\": " << s.unzipSeconds << ", \"read_s\": " << s.readSeconds
+            << ", \"real_s\": " << s.realSeconds << ", \"cpu_s\": " << s.cpuSeconds
+            << ", \"entries_per_read_s\": " << (s.readSeconds > 0 ? s.entries / s.readSeconds : 0)
+            << "}" << (k + 1 < inputs.size() ? ",\n" : "\n");
+    }
+    out << "  ]\n}\n";
+    return true;
+}
+
+#endif
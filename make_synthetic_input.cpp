@@ -0,0 +1,357 @@
+// Synthetic reco2 file for benchmarks and tests without the /pnfs samples.
+//
+// Writes the five trees read by anamacro_1gX_blips_signal (and T_pot) with
+// every branch of branch_manifest.h. The branches are created from the
+// set_vars globals themselves, so they have the types setBranches*() bind
+// to. The contents are random, with:
+//  - --events N events, in subruns of 50 events of run --run,
+//  - blip multiplicities drawn from --blips (poisson:MEAN, exp:MEAN,
+//    uniform:LO:HI or fixed:N), spread in a 150 cm sphere around the shower
+//    vertex,
+//  - a fraction --signal-pass of the events passing the signal
+//    preselection and --sideband-pass passing the sideband one
+//    (selection_variants.h); the others fail one of the generic or score cuts.
+//
+// g++ make_synthetic_input.cpp -o make_synthetic_input $(root-config --cflags --libs)
+
+#include <TFile.h>
+#include <TRandom3.h>
+#include <TString.h>
+#include <TTree.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "set_vars.h"
+#include "set_vars_pfeval.h"
+#include "set_vars_kine.h"
+#include "set_vars_taggerbdt.h"
+#include "set_vars_eval.h"
+#include "selection_variants.h"
+#include "branch_manifest.h"
+
+
+const int kEventsPerSubrun = 50;
+
+
+// Leaf type code of a set_vars scalar
+template <typename T> const char* LeafType();
+template <> const char* LeafType<float>()              { return "F"; }
+template <> const char* LeafType<double>()             { return "D"; }
+template <> const char* LeafType<int>()                { return "I"; }
+template <> const char* LeafType<unsigned int>()       { return "i"; }
+template <> const char* LeafType<short>()              { return "S"; }
+template <> const char* LeafType<Long64_t>()           { return "L"; }
+template <> const char* LeafType<bool>()               { return "O"; }
+
+template <typename T>
+void AddBranch(TTree* tree, const char* name, T& var) {
+    tree->Branch(name, &var, Form("%s/%s", name, LeafType<T>()));
+}
+template <typename T>
+void AddBranch(TTree* tree, const char* name, std::vector<T>*& var) {
+    if (!var) var = new std::vector<T>;
+    tree->Branch(name, &var);
+}
+// Fixed size array, or variable length with the count branch `count`
+template <typename T, size_t N>
+void AddBranch(TTree* tree, const char* name, T (&var)[N], const char* count = nullptr) {
+    tree->Branch(name, var, count ? Form("%s[%s]/%s", name, count, LeafType<T>()) : Form("%s[%zu]/%s", name, N, LeafType<T>()));
+}
+
+#define SYNTH_BRANCH(tree, var, ...) AddBranch(tree, #var, var, ##__VA_ARGS__)
+
+
+// Blip multiplicity distribution, from "poisson:40", "exp:40", "uniform:0:200" or "fixed:40"
+struct Multiplicity {
+    std::string kind;
+    double a = 0, b = 0;
+
+    bool Parse(const std::string& spec) {
+        std::stringstream ss(spec);
+        std::string value;
+        std::getline(ss, kind, ':');
+        std::vector<double> numbers;
+        while (std::getline(ss, value, ':')) numbers.push_back(std::atof(value.c_str()));
+        bool ok = (kind == "uniform" && numbers.size() == 2 && numbers[1] >= numbers[0] && numbers[0] >= 0) ||
+                  ((kind == "poisson" || kind == "exp" || kind == "fixed") && numbers.size() == 1 && numbers[0] >= 0);
+        if (!ok) {
+            std::cerr << "ERROR: --blips takes poisson:MEAN, exp:MEAN, uniform:LO:HI or fixed:N, got '" << spec << "'\n";
+            return false;
+        }
+        a = numbers[0];
+        b = numbers.size() > 1 ? numbers[1] : 0;
+        return true;
+    }
+
+    int Draw(TRandom3& rng) const {
+        if (kind == "poisson") return rng.Poisson(a);
+        if (kind == "exp")     return (int)rng.Exp(a);
+        if (kind == "uniform") return (int)rng.Uniform(a, b + 1);
+        return (int)a;
+    }
+};
+
+
+// Preselection variables of an event that passes the signal cuts (0), the
+// sideband cuts (1) or neither (2)
+void DrawPreselection(TRandom3& rng, int target) {
+    crtveto = 0;
+    kine_reco_Enu = rng.Uniform(100, 2000);
+    shw_sp_n_20mev_showers = 1 + rng.Integer(3);
+    reco_nuvtxX = rng.Uniform(5.5, 249.5);
+    single_photon_nue_score = rng.Uniform(-5, 5);
+    shw_sp_n_20br1_showers = (int)rng.Integer(3);
+
+    if (target == 0) {
+        single_photon_numu_score  = rng.Uniform(0.41, 1);
+        single_photon_other_score = rng.Uniform(0.21, 1);
+        single_photon_ncpi0_score = rng.Uniform(-0.04, 1);
+        single_photon_nue_score   = rng.Uniform(-0.99, 5);
+        shw_sp_n_20br1_showers    = 1;
+    } else if (target == 1) {
+        single_photon_numu_score  = rng.Uniform(0.11, 0.39);
+        single_photon_other_score = rng.Uniform(-0.39, 1);
+        single_photon_ncpi0_score = rng.Uniform(-19.9, -0.41);
+    } else {
+        single_photon_numu_score  = rng.Uniform(-1, 1);
+        single_photon_other_score = rng.Uniform(-1, 1);
+        single_photon_ncpi0_score = rng.Uniform(-20, 1);
+        switch (rng.Integer(4)) {   // which cut it fails
+            case 0: crtveto = 1; break;
+            case 1: reco_nuvtxX = rng.Uniform(-50, 5); break;
+            case 2: shw_sp_n_20mev_showers = 0; break;
+            default: single_photon_numu_score = rng.Uniform(-1, 0.09); break;
+        }
+    }
+}
+
+
+int main(int argc, char** argv) {
+
+    std::vector<std::string> positional;
+    Long64_t nEvents = 10000;
+    Multiplicity blips;
+    blips.Parse("poisson:40");
+    double signalPass = 0.05, sidebandPass = 0.05;
+    unsigned seed = 1;
+    int runNumber = 9000;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--events" && i + 1 < argc) nEvents = std::atoll(argv[++i]);
+        else if (arg == "--blips" && i + 1 < argc) { if (!blips.Parse(argv[++i])) return 1; }
+        else if (arg == "--signal-pass" && i + 1 < argc) signalPass = std::atof(argv[++i]);
+        else if (arg == "--sideband-pass" && i + 1 < argc) sidebandPass = std::atof(argv[++i]);
+        else if (arg == "--seed" && i + 1 < argc) seed = std::atoi(argv[++i]);
+        else if (arg == "--run" && i + 1 < argc) runNumber = std::atoi(argv[++i]);
+        else positional.push_back(arg);
+    }
+    if (positional.size() != 1 || nEvents < 1 || signalPass < 0 || sidebandPass < 0 || signalPass + sidebandPass > 1) {
+        std::cerr << "Usage:\n"
+                  << argv[0] << " <output.root> [--events N] [--blips poisson:40|exp:40|uniform:0:200|fixed:40]\n"
+                  << "       [--signal-pass 0.05] [--sideband-pass 0.05] [--seed 1] [--run 9000]\n";
+        return 1;
+    }
+
+    TFile out(positional[0].c_str(), "RECREATE");
+    if (out.IsZombie()) {
+        std::cerr << "ERROR: cannot create " << positional[0] << "\n";
+        return 1;
+    }
+
+    // --- Trees, with the branches of the manifest ---
+    out.mkdir("nuselection")->cd();
+    TTree* pelee = new TTree("NeutrinoSelectionFilter", "synthetic");
+    SYNTH_BRANCH(pelee, run);
+    SYNTH_BRANCH(pelee, sub);
+    SYNTH_BRANCH(pelee, evt);
+    SYNTH_BRANCH(pelee, crtveto);
+    SYNTH_BRANCH(pelee, reco_nu_vtx_x);
+    SYNTH_BRANCH(pelee, reco_nu_vtx_y);
+    SYNTH_BRANCH(pelee, reco_nu_vtx_z);
+    SYNTH_BRANCH(pelee, nblips_saved);
+    SYNTH_BRANCH(pelee, blip_x);
+    SYNTH_BRANCH(pelee, blip_y);
+    SYNTH_BRANCH(pelee, blip_z);
+    SYNTH_BRANCH(pelee, blip_energy);
+    SYNTH_BRANCH(pelee, blip_nplanes);
+    SYNTH_BRANCH(pelee, blip_touchtrk);
+    SYNTH_BRANCH(pelee, blip_pl2_bydeadwire);
+    SYNTH_BRANCH(pelee, blip_proxtrkdist);
+    SYNTH_BRANCH(pelee, blip_true_g4id);
+    SYNTH_BRANCH(pelee, blip_true_pdg);
+
+    // Wire-Cell event ids (event_alignment.h)
+    Int_t wcRun = 0, wcSubrun = 0, wcEvent = 0;
+    auto addIds = [&](TTree* tree) {
+        tree->Branch("run", &wcRun, "run/I");
+        tree->Branch("subrun", &wcSubrun, "subrun/I");
+        tree->Branch("event", &wcEvent, "event/I");
+    };
+
+    out.mkdir("wcpselection")->cd();
+    TTree* pfeval = new TTree("T_PFeval", "synthetic");
+    addIds(pfeval);
+    SYNTH_BRANCH(pfeval, reco_nuvtxX);
+    SYNTH_BRANCH(pfeval, reco_nuvtxY);
+    SYNTH_BRANCH(pfeval, reco_nuvtxZ);
+    SYNTH_BRANCH(pfeval, reco_showervtxX);
+    SYNTH_BRANCH(pfeval, reco_showervtxY);
+    SYNTH_BRANCH(pfeval, reco_showervtxZ);
+    SYNTH_BRANCH(pfeval, reco_showerMomentum);
+    SYNTH_BRANCH(pfeval, truth_single_photon);
+    SYNTH_BRANCH(pfeval, truth_NCDelta);
+    SYNTH_BRANCH(pfeval, truth_showerMother);
+    SYNTH_BRANCH(pfeval, truth_Npi0);
+    SYNTH_BRANCH(pfeval, truth_muonMomentum);
+
+    TTree* kine = new TTree("T_KINEvars", "synthetic");
+    SYNTH_BRANCH(kine, kine_reco_Enu);
+    SYNTH_BRANCH(kine, kine_nparticles);
+    SYNTH_BRANCH(kine, kine_energy_particle, "kine_nparticles");
+    SYNTH_BRANCH(kine, kine_particle_type, "kine_nparticles");
+
+    TTree* bdt = new TTree("T_BDTvars", "synthetic");
+    SYNTH_BRANCH(bdt, numu_cc_flag);
+    SYNTH_BRANCH(bdt, single_photon_numu_score);
+    SYNTH_BRANCH(bdt, single_photon_other_score);
+    SYNTH_BRANCH(bdt, single_photon_ncpi0_score);
+    SYNTH_BRANCH(bdt, single_photon_nue_score);
+    SYNTH_BRANCH(bdt, shw_sp_n_20mev_showers);
+    SYNTH_BRANCH(bdt, shw_sp_n_20br1_showers);
+
+    TTree* eval = new TTree("T_eval", "synthetic");
+    addIds(eval);
+    SYNTH_BRANCH(eval, match_completeness_energy);
+    SYNTH_BRANCH(eval, truth_energyInside);
+    SYNTH_BRANCH(eval, truth_isCC);
+    SYNTH_BRANCH(eval, truth_vtxInside);
+    SYNTH_BRANCH(eval, truth_nuPdg);
+
+    Int_t potRun = 0, potSubrun = 0;
+    Double_t pot = 0;
+    TTree* potTree = new TTree("T_pot", "synthetic");
+    potTree->Branch("runNo", &potRun, "runNo/I");
+    potTree->Branch("subRunNo", &potSubrun, "subRunNo/I");
+    potTree->Branch("pot_tor875good", &pot, "pot_tor875good/D");
+
+    for (const char* path : {kPeLEETree, kPFevalTree, kKINETree, kBDTTree, kEvalTree}) {
+        TTree* tree = out.Get<TTree>(path);
+        for (const std::string& name : ManifestBranches(path))
+            if (!tree || !tree->GetBranch(name.c_str())) {
+                std::cerr << "ERROR: " << path << " has no branch " << name << " of the manifest\n";
+                return 1;
+            }
+    }
+
+    // --- Events ---
+    TRandom3 rng(seed);
+    const size_t kMaxKine = sizeof(kine_particle_type) / sizeof(kine_particle_type[0]);
+    const int kKinePdg[] = {2212, 13, 211, 111, 22, 11, 2112};
+    const int kBlipPdg[] = {2212, 11, 22, 2112, 13, 0};
+    Long64_t nBlips = 0, nSignal = 0, nSideband = 0;
+
+    for (Long64_t i = 0; i < nEvents; ++i) {
+        run = runNumber;
+        sub = 1 + i / kEventsPerSubrun;
+        evt = 1 + i;
+        wcRun = run;
+        wcSubrun = sub;
+        wcEvent = evt;
+
+        double u = rng.Uniform();
+        int target = u < signalPass ? 0 : u < signalPass + sidebandPass ? 1 : 2;
+        DrawPreselection(rng, target);
+        PreselectionInputs presel = { (double)crtveto, (double)kine_reco_Enu, (double)shw_sp_n_20mev_showers,
+                                      (double)reco_nuvtxX, (double)single_photon_numu_score,
+                                      (double)single_photon_other_score, (double)single_photon_ncpi0_score,
+                                      (double)single_photon_nue_score, (double)shw_sp_n_20br1_showers };
+        bool signal = PassesPreselection(kSignalCuts, presel), sideband = PassesPreselection(kSidebandCuts, presel);
+        if (signal != (target == 0) || sideband != (target == 1)) {
+            std::cerr << "ERROR: event " << i << " does not pass the preselection it was drawn for\n";
+            return 1;
+        }
+        nSignal += signal;
+        nSideband += sideband;
+
+        // Vertices and shower
+        reco_nuvtxY = rng.Uniform(-100, 100);
+        reco_nuvtxZ = rng.Uniform(20, 1000);
+        reco_nu_vtx_x = reco_nuvtxX;
+        reco_nu_vtx_y = reco_nuvtxY;
+        reco_nu_vtx_z = reco_nuvtxZ;
+        reco_showervtxX = reco_nuvtxX + rng.Gaus(0, 20);
+        reco_showervtxY = reco_nuvtxY + rng.Gaus(0, 20);
+        reco_showervtxZ = reco_nuvtxZ + rng.Gaus(0, 20);
+        double px, py, pz, showerE = rng.Uniform(50, 1000);
+        rng.Sphere(px, py, pz, showerE);
+        reco_showerMomentum[0] = px;
+        reco_showerMomentum[1] = py;
+        reco_showerMomentum[2] = pz;
+        reco_showerMomentum[3] = showerE;
+
+        // Blips in a sphere around the shower vertex
+        int n = std::max(0, blips.Draw(rng));
+        nblips_saved = n;
+        for (auto* v : {blip_x, blip_y, blip_z, blip_energy, blip_proxtrkdist}) v->clear();
+        for (auto* v : {blip_nplanes, blip_touchtrk, blip_pl2_bydeadwire, blip_true_g4id, blip_true_pdg}) v->clear();
+        for (int b = 0; b < n; ++b) {
+            double x, y, z, r = 150 * std::cbrt(rng.Uniform());
+            rng.Sphere(x, y, z, r);
+            blip_x->push_back(reco_showervtxX + x);
+            blip_y->push_back(reco_showervtxY + y);
+            blip_z->push_back(reco_showervtxZ + z);
+            blip_energy->push_back(rng.Exp(0.5));
+            blip_nplanes->push_back(1 + rng.Integer(3));
+            blip_touchtrk->push_back(rng.Uniform() < 0.1);
+            blip_pl2_bydeadwire->push_back(rng.Uniform() < 0.05);
+            blip_proxtrkdist->push_back(rng.Uniform(0, 100));
+            blip_true_g4id->push_back(rng.Uniform() < 0.3 ? -1 : (int)rng.Integer(1000));
+            blip_true_pdg->push_back(kBlipPdg[rng.Integer(6)]);
+        }
+        nBlips += n;
+
+        // Reconstructed particles
+        numu_cc_flag = (int)rng.Integer(3) - 1;
+        kine_nparticles = std::min<size_t>(rng.Poisson(3), kMaxKine);
+        for (int k = 0; k < kine_nparticles; ++k) {
+            kine_particle_type[k] = kKinePdg[rng.Integer(7)];
+            kine_energy_particle[k] = rng.Exp(100);
+        }
+
+        // Truth
+        truth_single_photon = rng.Uniform() < 0.3;
+        truth_isCC = rng.Uniform() < 0.5;
+        truth_nuPdg = rng.Uniform() < 0.8 ? 14 : 12;
+        truth_NCDelta = rng.Uniform() < 0.1;
+        truth_vtxInside = rng.Uniform() < 0.9;
+        truth_showerMother = rng.Uniform() < 0.5 ? 111 : 22;
+        truth_Npi0 = rng.Poisson(0.5);
+        truth_muonMomentum[3] = truth_isCC && truth_nuPdg == 14 ? 0.105658 + rng.Exp(0.3) : 0;
+        truth_energyInside = rng.Uniform(100, 2000);
+        match_completeness_energy = truth_energyInside * rng.Uniform();
+
+        pelee->Fill();
+        pfeval->Fill();
+        kine->Fill();
+        bdt->Fill();
+        eval->Fill();
+        if (i % kEventsPerSubrun == 0) {
+            potRun = run;
+            potSubrun = sub;
+            pot = 1e16;
+            potTree->Fill();
+        }
+    }
+
+    out.Write();
+    out.Close();
+    std::cout << "Wrote " << nEvents << " events, " << nBlips << " blips (" << nSignal << " signal, "
+              << nSideband << " sideband preselection) to " << positional[0] << std::endl;
+    return 0;
+}
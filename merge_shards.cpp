@@ -0,0 +1,155 @@
+// Merges the output files of several anamacro_1gX_blips_signal jobs (one
+// variant, e.g. the --shard i/N jobs of one sample, or one job per file) into
+// one, see shard_merge.h. Use this instead of hadd.
+//
+// The files are merged as a tree: groups of --fanin files are merged by up to
+// --threads forked workers into scratch files, then the groups of those, and
+// so on, until one step merges the rest into the output.
+
+#include <TFile.h>
+#include <TString.h>
+#include <TSystem.h>
+
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "input_files.h"
+#include "shard_merge.h"
+#include "hist_bundle.h"
+
+
+// Merges each group of `files` in a worker process, at most nWorkers at a time
+bool MergeGroups(const std::vector<std::vector<std::string>>& groups, const std::vector<std::string>& outputs,
+                 int nWorkers) {
+
+    bool ok = true;
+    size_t next = 0;
+    int running = 0;
+    while (running > 0 || (ok && next < groups.size())) {
+
+        if (ok && next < groups.size() && running < nWorkers) {
+            std::cout.flush();
+            pid_t pid = fork();
+            if (pid < 0) {
+                std::cerr << "ERROR: fork() failed for merge group " << next << "\n";
+                ok = false;
+                continue;
+            }
+            if (pid == 0) _exit(MergeFiles(groups[next], outputs[next]) ? 0 : 1);
+            next++;
+            running++;
+            continue;
+        }
+
+        int status = 0;
+        if (wait(&status) < 0) break;
+        running--;
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) ok = false;
+    }
+    return ok;
+}
+
+
+int main(int argc, char** argv) {
+
+    std::vector<std::string> positional;
+    int nWorkers = 1;
+    size_t fanIn = 8;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--threads" && i + 1 < argc) nWorkers = std::max(1, atoi(argv[++i]));
+        else if (arg == "--fanin" && i + 1 < argc) fanIn = std::max(2, atoi(argv[++i]));
+        else if (arg == "--hist-bundle") gWriteHistBundle = true;
+        else positional.push_back(arg);
+    }
+
+    if (positional.size() < 2) {
+        std::cerr << "Usage:\n"
+                  << argv[0] << " [--threads N] [--fanin K] [--hist-bundle] <output.root> <shard.root|'glob*.root'|files.list> [...]\n"
+                  << "Options:\n"
+                  << "  --threads N      merge with up to N worker processes\n"
+                  << "  --fanin K        files merged per worker and step (default 8)\n"
+                  << "  --hist-bundle    also write <output>.hbundle (hist_bundle.h)\n";
+        return 1;
+    }
+
+    std::string output = positional[0];
+    std::vector<std::string> files;
+    for (size_t i = 1; i < positional.size(); ++i) {
+        std::vector<std::string> expanded = ExpandInputFiles(positional[i]);
+        if (expanded.empty()) return 1;
+        files.insert(files.end(), expanded.begin(), expanded.end());
+    }
+
+    // Same configuration everywhere, no entry in two shards
+    std::string config;
+    std::vector<EventRangeSettings> ranges(files.size());
+    for (size_t i = 0; i < files.size(); ++i) {
+        std::unique_ptr<TFile> in(TFile::Open(files[i].c_str()));
+        if (!in || in->IsZombie()) {
+            std::cerr << "ERROR: cannot open " << files[i] << "\n";
+            return 1;
+        }
+        std::string fileConfig = ReadSelectionConfig(in.get());
+        if (fileConfig.empty() || !ReadEventRange(in.get(), ranges[i])) {
+            std::cerr << "ERROR: " << files[i] << " has no " << kSelectionConfig << " or " << kEventRangeDir
+                      << "/, it was not written by this version of anamacro_1gX_blips_signal\n";
+            return 1;
+        }
+        if (i == 0) config = fileConfig;
+        else if (fileConfig != config) {
+            std::cerr << "ERROR: " << files[i] << " was made with another selection than " << files[0] << ":\n"
+                      << fileConfig << "instead of\n" << config;
+            return 1;
+        }
+    }
+    EventRangeSettings merged;
+    if (!CheckEventRanges(files, ranges, merged)) return 1;
+
+    std::cout << "Merging " << files.size() << " files into " << output << std::endl;
+
+    // Reduction steps over scratch files
+    std::vector<std::string> scratch;
+    bool ok = true;
+    for (int step = 0; ok && files.size() > fanIn; ++step) {
+        std::vector<std::vector<std::string>> groups;
+        std::vector<std::string> outputs;
+        for (size_t i = 0; i < files.size(); i += fanIn) {
+            groups.emplace_back(files.begin() + i, files.begin() + std::min(files.size(), i + fanIn));
+            outputs.push_back(Form("%s/merge_shards_%d_%d_%zu.root", gSystem->TempDirectory(), getpid(), step, groups.size() - 1));
+        }
+        std::cout << "Step " << step << ": " << files.size() << " files -> " << groups.size() << std::endl;
+        ok = MergeGroups(groups, outputs, nWorkers);
+        for (const std::string& file : scratch) gSystem->Unlink(file.c_str());
+        scratch = outputs;
+        files = outputs;
+    }
+    ok = ok && MergeFiles(files, output, &merged);
+    for (const std::string& file : scratch) gSystem->Unlink(file.c_str());
+    if (!ok) {
+        std::cerr << "ERROR: merge failed, " << output << " is not complete\n";
+        return 1;
+    }
+
+    // Same print-out as a single job
+    std::unique_ptr<TFile> out(TFile::Open(output.c_str()));
+    TParameter<Long64_t>* signal = nullptr;
+    out->GetObject(Form("%s/signal_events", kCountersDir), signal);
+    if (signal)
+        std::cout << "signal events/total events = " << signal->GetVal() << " / " << merged.accepted << " = "
+                  << (float)signal->GetVal() / merged.accepted << std::endl;
+    if (merged.begin >= 0)
+        std::cout << "Entries [" << merged.begin << ", " << merged.end << ") of " << merged.input << std::endl;
+    std::cout << "Merged file written to " << output << std::endl;
+    if (gWriteHistBundle) {
+        std::string bundle = BundleBaseName(output);
+        if (!WriteHistBundle(bundle, out.get())) return 1;
+        std::cout << "Histogram bundle written to " << bundle << std::endl;
+    }
+    return 0;
+}
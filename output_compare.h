@@ -0,0 +1,221 @@
+// Bin by bin comparison of two anamacro output files (compare_runs.cpp).
+//
+// A faster configuration of the selection (--threads, --engine rdf, another
+// build) has to give the same histograms as the reference one. CompareFiles()
+// walks both files and compares
+//  - every histogram: dimension, binning (variable bin edges included),
+//    entries, and the content and error of every bin including under/overflow,
+//  - every TParameter (counters/, event_range/),
+//  - every tree (evd_tree, bdt_scan): entries and leaves, and the value of
+//    every leaf of every entry, as merge_shards reads them (MergeTree),
+// with a relative tolerance: |a - b| <= tolerance * max(|a|, |b|). An object
+// present in only one of the files is a mismatch. Histograms that depend on
+// the run and not on the events (kCompareIgnored: the loop timing) are
+// skipped.
+
+#ifndef OUTPUT_COMPARE_H
+#define OUTPUT_COMPARE_H
+
+#include <TDirectory.h>
+#include <TFile.h>
+#include <TH1.h>
+#include <TKey.h>
+#include <TLeaf.h>
+#include <TObjArray.h>
+#include <TParameter.h>
+#include <TTree.h>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+
+const std::set<std::string> kCompareIgnored = {"h_cutflow_time"};   // cut_flow.h
+
+const int kMaxReportedBins = 5;   // mismatching bins printed per histogram
+
+
+struct CompareResult {
+    int    histograms = 0;
+    int    parameters = 0;
+    int    trees = 0;
+    int    mismatches = 0;     // objects that differ or are missing
+    double maxDiff = 0;        // largest relative difference seen
+};
+
+
+inline double RelativeDiff(double a, double b) {
+    if (a == b) return 0;
+    return std::fabs(a - b) / std::max(std::fabs(a), std::fabs(b));
+}
+
+inline bool SameAxis(const TAxis* a, const TAxis* b) {
+    if (a->GetNbins() != b->GetNbins() || a->GetXmin() != b->GetXmin() || a->GetXmax() != b->GetXmax()) return false;
+    const TArrayD* edgesA = a->GetXbins();
+    const TArrayD* edgesB = b->GetXbins();
+    if (edgesA->GetSize() != edgesB->GetSize()) return false;   // variable against fixed bins
+    for (int i = 0; i < edgesA->GetSize(); ++i)
+        if (edgesA->GetAt(i) != edgesB->GetAt(i)) return false;
+    return true;
+}
+
+
+inline bool CompareHistograms(const TH1* a, const TH1* b, const std::string& path, double tolerance, CompareResult& result) {
+    result.histograms++;
+    if (a->GetDimension() != b->GetDimension() || a->GetNcells() != b->GetNcells() ||
+        !SameAxis(a->GetXaxis(), b->GetXaxis()) || !SameAxis(a->GetYaxis(), b->GetYaxis())) {
+        std::cout << " MISMATCH " << path << ": different binning\n";
+        result.mismatches++;
+        return false;
+    }
+
+    int bad = 0;
+    double entries = RelativeDiff(a->GetEntries(), b->GetEntries());
+    result.maxDiff = std::max(result.maxDiff, entries);
+    if (entries > tolerance) {
+        std::cout << " MISMATCH " << path << ": entries " << a->GetEntries() << " vs " << b->GetEntries() << "\n";
+        bad++;
+    }
+    for (int bin = 0; bin < a->GetNcells(); ++bin) {
+        double content = RelativeDiff(a->GetBinContent(bin), b->GetBinContent(bin));
+        double error   = RelativeDiff(a->GetBinError(bin), b->GetBinError(bin));
+        result.maxDiff = std::max({result.maxDiff, content, error});
+        if (content <= tolerance && error <= tolerance) continue;
+        if (bad++ < kMaxReportedBins)
+            std::cout << " MISMATCH " << path << ": bin " << bin << " " << a->GetBinContent(bin) << " +- "
+                      << a->GetBinError(bin) << " vs " << b->GetBinContent(bin) << " +- " << b->GetBinError(bin) << "\n";
+    }
+    if (bad > kMaxReportedBins)
+        std::cout << " MISMATCH " << path << ": " << bad - kMaxReportedBins << " more bins\n";
+    if (bad) result.mismatches++;
+    return bad == 0;
+}
+
+template <typename T>
+inline bool CompareParameters(const TParameter<T>* a, const TParameter<T>* b, const std::string& path, double tolerance,
+                              CompareResult& result) {
+    result.parameters++;
+    double diff = RelativeDiff(a->GetVal(), b->GetVal());
+    result.maxDiff = std::max(result.maxDiff, diff);
+    if (diff <= tolerance) return true;
+    std::cout << " MISMATCH " << path << ": " << a->GetVal() << " vs " << b->GetVal() << "\n";
+    result.mismatches++;
+    return false;
+}
+
+// Entry by entry, leaf by leaf (the trees of the outputs only have numeric
+// leaves, see MergeTree in shard_merge.h)
+inline bool CompareTrees(TTree* a, TTree* b, const std::string& path, double tolerance, CompareResult& result) {
+    result.trees++;
+    TObjArray* leavesA = a->GetListOfLeaves();
+    TObjArray* leavesB = b->GetListOfLeaves();
+    bool sameLeaves = a->GetEntries() == b->GetEntries() && leavesA->GetEntries() == leavesB->GetEntries();
+    for (int i = 0; sameLeaves && i < leavesA->GetEntries(); ++i) {
+        TLeaf* leafA = (TLeaf*)leavesA->At(i);
+        TLeaf* leafB = (TLeaf*)leavesB->At(i);
+        sameLeaves = std::string(leafA->GetName()) == leafB->GetName() && leafA->GetLen() == leafB->GetLen();
+    }
+    if (!sameLeaves) {
+        std::cout << " MISMATCH " << path << ": " << a->GetEntries() << " vs " << b->GetEntries()
+                  << " entries, or different leaves\n";
+        result.mismatches++;
+        return false;
+    }
+
+    int bad = 0;
+    for (Long64_t entry = 0; entry < a->GetEntries(); ++entry) {
+        a->GetEntry(entry);
+        b->GetEntry(entry);
+        for (int i = 0; i < leavesA->GetEntries(); ++i) {
+            TLeaf* leafA = (TLeaf*)leavesA->At(i);
+            TLeaf* leafB = (TLeaf*)leavesB->At(i);
+            for (int j = 0; j < leafA->GetLen(); ++j) {
+                double diff = RelativeDiff(leafA->GetValue(j), leafB->GetValue(j));
+                result.maxDiff = std::max(result.maxDiff, diff);
+                if (diff <= tolerance) continue;
+                if (bad++ < kMaxReportedBins)
+                    std::cout << " MISMATCH " << path << ": entry " << entry << " " << leafA->GetName() << " "
+                              << leafA->GetValue(j) << " vs " << leafB->GetValue(j) << "\n";
+            }
+        }
+    }
+    if (bad > kMaxReportedBins)
+        std::cout << " MISMATCH " << path << ": " << bad - kMaxReportedBins << " more values\n";
+    if (bad) result.mismatches++;
+    return bad == 0;
+}
+
+
+// Compared classes: histograms, TParameters and trees
+inline bool IsCompared(const std::string& className) {
+    return className.rfind("TH", 0) == 0 || className.rfind("TParameter", 0) == 0 || className == "TTree";
+}
+
+// Compares the objects of a with the ones of the same name in b
+// (path: dir/ of both, for the messages)
+inline void CompareDirectories(TDirectory* a, TDirectory* b, const std::string& path, double tolerance, CompareResult& result) {
+
+    std::set<std::string> seen;   // keys come highest cycle first
+    TIter next(a->GetListOfKeys());
+    while (TKey* key = (TKey*)next()) {
+        std::string name = key->GetName(), className = key->GetClassName();
+        if (!seen.insert(name).second || kCompareIgnored.count(name)) continue;
+        std::string where = path + name;
+
+        if (className == "TDirectoryFile") {
+            TDirectory* other = b->GetDirectory(name.c_str());
+            if (other) CompareDirectories(a->GetDirectory(name.c_str()), other, where + "/", tolerance, result);
+            else {
+                std::cout << " MISMATCH " << where << "/: only in the first file\n";
+                result.mismatches++;
+            }
+            continue;
+        }
+        if (!IsCompared(className)) continue;
+
+        std::unique_ptr<TObject> objA(key->ReadObj());
+        TKey* keyB = b->GetKey(name.c_str());
+        std::unique_ptr<TObject> objB(keyB && className == keyB->GetClassName() ? keyB->ReadObj() : nullptr);
+        if (!objB) {
+            std::cout << " MISMATCH " << where << ": only in the first file\n";
+            result.mismatches++;
+        } else if (objA->InheritsFrom("TTree")) {
+            CompareTrees((TTree*)objA.get(), (TTree*)objB.get(), where, tolerance, result);
+        } else if (objA->InheritsFrom("TH1")) {
+            CompareHistograms((TH1*)objA.get(), (TH1*)objB.get(), where, tolerance, result);
+        } else if (className == "TParameter<Long64_t>") {
+            CompareParameters((TParameter<Long64_t>*)objA.get(), (TParameter<Long64_t>*)objB.get(), where, tolerance, result);
+        } else if (className == "TParameter<double>") {
+            CompareParameters((TParameter<double>*)objA.get(), (TParameter<double>*)objB.get(), where, tolerance, result);
+        }
+    }
+
+    // Objects only in b
+    TIter nextB(b->GetListOfKeys());
+    while (TKey* key = (TKey*)nextB()) {
+        std::string name = key->GetName(), className = key->GetClassName();
+        if (seen.count(name) || kCompareIgnored.count(name)) continue;
+        seen.insert(name);
+        if (className != "TDirectoryFile" && !IsCompared(className)) continue;
+        std::cout << " MISMATCH " << path << name << ": only in the second file\n";
+        result.mismatches++;
+    }
+}
+
+
+// False if a file cannot be opened
+inline bool CompareFiles(const std::string& fileA, const std::string& fileB, double tolerance, CompareResult& result) {
+    std::unique_ptr<TFile> a(TFile::Open(fileA.c_str())), b(TFile::Open(fileB.c_str()));
+    if (!a || a->IsZombie() || !b || b->IsZombie()) {
+        std::cerr << "ERROR: cannot open " << (!a || a->IsZombie() ? fileA : fileB) << "\n";
+        return false;
+    }
+    CompareDirectories(a.get(), b.get(), "", tolerance, result);
+    return true;
+}
+
+#endif
@@ -0,0 +1,170 @@
+// Sphere radius scan (--radius-scan R1,R2,...).
+//
+// The sphere radius of a pass (SelectionPass::Radius, 75 cm) decides which
+// blips count for the 0n/Nn split and the back-tracked protons, so trying
+// another radius meant recompiling and rerunning. With --radius-scan every
+// pass also classifies the blips once with the largest radius, sorts the
+// sphere blips by distance to the shower vertex, and walks that list once per
+// radius: only the blips inside a radius are looked at for it. For each radius
+// the number of protons (all/0n/Nn), the signal blip multiplicity and summed
+// energy are histogrammed, with the names of the main histograms, in
+// radius_scan/R<radius>/ of the output file.
+//
+// The cone test (IsWithinSphereOutsideConic) takes the radius, so it is
+// redone for every radius below the largest one. Energies are summed in blip
+// order as in FillEvent, so the radius of the pass reproduces its main
+// histograms exactly.
+//
+// Include after set_vars.h and common_funtions.h.
+
+#ifndef RADIUS_SCAN_H
+#define RADIUS_SCAN_H
+
+#include <TDirectory.h>
+#include <TH1F.h>
+#include <TH2F.h>
+#include <TString.h>
+#include <TVector3.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "blip_kernel.h"
+#include "event_summary.h"
+
+
+const size_t kMaxScanRadii = 32;   // one bit per radius
+
+
+struct RadiusScanSettings {
+    std::vector<float> radii;   // ascending, empty: no scan
+};
+
+inline RadiusScanSettings gRadiusScan;
+
+// "50,60,75,90" -> ascending list of distinct radii [cm]
+inline bool ParseScanRadii(const std::string& list, std::vector<float>& radii) {
+    radii.clear();
+    std::stringstream ss(list);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        char* end = nullptr;
+        float r = std::strtof(item.c_str(), &end);
+        if (item.empty() || *end != '\0' || !(r > 0)) {
+            std::cerr << "ERROR: bad radius '" << item << "' in --radius-scan " << list << "\n";
+            return false;
+        }
+        radii.push_back(r);
+    }
+    std::sort(radii.begin(), radii.end());
+    radii.erase(std::unique(radii.begin(), radii.end()), radii.end());
+    if (radii.empty() || radii.size() > kMaxScanRadii) {
+        std::cerr << "ERROR: --radius-scan takes 1 to " << kMaxScanRadii << " radii, got '" << list << "'\n";
+        return false;
+    }
+    return true;
+}
+
+
+class RadiusScan {
+public:
+
+    // One directory per radius under radius_scan/ of out
+    void Book(TDirectory* out) {
+        TDirectory* top = out->mkdir("radius_scan");
+        const char* splitTitle[] = {"", " - 0n", " - Nn"};
+        for (float radius : gRadiusScan.radii) {
+            top->mkdir(Form("R%g", radius))->cd();
+            Hists h;
+            for (int split = 0; split < 3; ++split) {
+                std::string suffix = kSplitSuffix[split];
+                std::string title = std::string(Form("R = %g cm", radius)) + splitTitle[split];
+                h.nprotons[split] = new TH1F(("h_1gX_Nprotons" + suffix).c_str(),
+                                             (title + "; Number of Protons; Events").c_str(), 10, 0, 10);
+                h.multiplicity[split] = new TH1F(("h_1gX_BlipMultiplicity" + suffix).c_str(),
+                                                 (title + "; Blip multiplicity ; counts").c_str(), 100, 0, 100);
+                h.sumE[split] = new TH1F(("h_1gX_SumEblip" + suffix).c_str(),
+                                         (title + "; Summed blip energy [MeV_{ee}]; Counts").c_str(), 100, 0, 100);
+            }
+            h.multiplicitySumE = new TH2F("h2D_1gX_BlipMultiplicity_SumEblip",
+                                          Form("R = %g cm; Blip multiplicity ; Sum E blip", radius), 100, 0, 100, 100, 0, 100);
+            fHists.push_back(h);
+        }
+        out->cd();
+    }
+
+    void Fill(const BlipBatch& blips, const TVector3& ShVtx, const TVector3& ShowerMomentum,
+              const EventSummary& event, bool AddBacktrackedBlips) {
+
+        const std::vector<float>& radii = gRadiusScan.radii;
+        size_t nradii = radii.size();
+        float Rmax = radii.back();
+
+        ClassifyBlips(blips, ShVtx, ShowerMomentum, Rmax, fGeo);
+
+        // Sphere blips of the largest radius, nearest first
+        fOrder.clear();
+        for (size_t i = 0; i < blips.n; ++i)
+            if (fGeo.flags[i] & kBlipSphere) fOrder.push_back(i);
+        std::stable_sort(fOrder.begin(), fOrder.end(),
+                         [this](size_t a, size_t b) { return fGeo.dist2vtx[a] < fGeo.dist2vtx[b]; });
+
+        // Bit k of fSignal[i]: blip i is a signal blip for radii[k]
+        fSignal.assign(blips.n, 0);
+        for (size_t k = 0; k < nradii; ++k) {
+            for (size_t i : fOrder) {
+                if (!(fGeo.dist2vtx[i] < radii[k])) break;
+                bool signal = radii[k] == Rmax
+                            ? (fGeo.flags[i] & kBlipSignal) != 0
+                            : IsWithinSphereOutsideConic(ShVtx, ShowerMomentum, TVector3(blips.x[i], blips.y[i], blips.z[i]), radii[k]);
+                if (signal) fSignal[i] |= uint32_t(1) << k;
+            }
+        }
+
+        // Counts in blip order, like SummarizeBlips
+        int   n[kMaxScanRadii] = {0}, nRegB[kMaxScanRadii] = {0};
+        float SumE[kMaxScanRadii] = {0};
+        for (size_t i = 0; i < blips.n; ++i) {
+            if (!fSignal[i]) continue;
+            bool regB = (fGeo.flags[i] & kBlipSignal) ? (fGeo.flags[i] & kBlipRegB) != 0
+                                                      : IsBackTrackedBlip(fGeo.dist2vtx[i], fGeo.cosangle[i]);
+            for (size_t k = 0; k < nradii; ++k) {
+                if (!(fSignal[i] >> k & 1)) continue;
+                n[k]++;
+                SumE[k] += blips.energy[i];
+                if (regB) nRegB[k]++;
+            }
+        }
+
+        for (size_t k = 0; k < nradii; ++k) {
+            int N_rec_protons = AddBacktrackedBlips ? event.WC_N_rec_protons + nRegB[k] : event.WC_N_rec_protons;
+            Hists& h = fHists[k];
+            for (int split : {(int)kSplitAll, Is0n(n[k], SumE[k]) ? (int)kSplit0n : (int)kSplitNn}) {
+                h.nprotons[split]->Fill(N_rec_protons);
+                h.multiplicity[split]->Fill(n[k]);
+                h.sumE[split]->Fill(SumE[k]);
+            }
+            h.multiplicitySumE->Fill(n[k], SumE[k]);
+        }
+    }
+
+private:
+    struct Hists {
+        TH1F* nprotons[3];       // all, 0n, Nn (EventSplit order)
+        TH1F* multiplicity[3];
+        TH1F* sumE[3];
+        TH2F* multiplicitySumE;
+    };
+    std::vector<Hists> fHists;   // one per radius, owned by the output file
+
+    BlipGeometry          fGeo;      // blips classified with the largest radius
+    std::vector<size_t>   fOrder;
+    std::vector<uint32_t> fSignal;
+};
+
+#endif
@@ -0,0 +1,261 @@
+// RDataFrame version of the 1gX selection (--engine rdf).
+//
+// The hand-written loop reads the branches into the set_vars globals and fills
+// the histograms one event at a time. Here the same preselection, blip loop
+// and truth categories are written as Filter/Define nodes on one RDataFrame
+// over the trees of all files, and every histogram is booked as a lazy action,
+// so a single (implicit-MT) event loop fills all variants and only the columns
+// used below are read. The blips and the EventSummary are defined once, on the
+// events passing any variant (DefineEventColumns); each variant only adds its
+// preselection and proton count on top (DefineSelectionColumns).
+//
+// The column types are taken from the set_vars declarations (RDFColumn), so
+// both engines read the branches with the same types; include this after the
+// set_vars headers and common_funtions.h. The Defines are pure functions of
+// their columns, the set_vars globals themselves are never touched.
+
+#ifndef RDF_ENGINE_H
+#define RDF_ENGINE_H
+
+#include <ROOT/RDataFrame.hxx>
+#include <ROOT/RVec.hxx>
+#include <TVector3.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "blip_kernel.h"
+#include "event_summary.h"
+#include "histogram_registry.h"
+#include "branch_manifest.h"
+#include "selection_variants.h"
+#include "skim.h"
+
+
+// RDataFrame column type of a set_vars branch variable:
+// vector branches and fixed-size arrays are read as RVec, scalars as is.
+template <typename T> struct RDFColumnOf { using type = T; };
+template <typename T> struct RDFColumnOf<std::vector<T>*> { using type = ROOT::RVec<T>; };
+template <typename T, size_t N> struct RDFColumnOf<T[N]> { using type = ROOT::RVec<T>; };
+
+#define RDFColumn(var) const RDFColumnOf<decltype(var)>::type&
+
+
+// Per-blip quantities of one event. Angles are only computed for sphere blips
+// (0 otherwise), like in the hand-written loop.
+struct BlipColumns {
+    ROOT::RVec<BlipElementOf<decltype(blip_energy)>> energy;
+    ROOT::RVec<float>  dist2vtx;
+    ROOT::RVec<double> angle;
+    ROOT::RVec<double> cosangle;
+    ROOT::RVec<int>    flags;
+};
+
+
+// Data frame over the five trees of all files, with the WC trees as friends of
+// the PeLEE tree (or the skim tree alone), limited to the entries [first, last)
+// of the chain. The range is part of the data source, so only those entries
+// are read, and under implicit MT they are the same entries as in the loop
+// engine (a Filter on rdfentry_ is not: its numbering follows the processing
+// order of the tasks).
+inline std::unique_ptr<ROOT::RDataFrame> MakeDataFrame(const std::vector<std::string>& files, bool isSkim,
+                                                        Long64_t first, Long64_t last) {
+
+    using ROOT::RDF::Experimental::RDatasetSpec;
+    using ROOT::RDF::Experimental::RSample;
+
+    RDatasetSpec spec;
+    spec.AddSample(RSample("input", isSkim ? kSkimTree : kPeLEETree, files));
+    if (!isSkim)
+        for (const char* path : { kPFevalTree, kKINETree, kBDTTree, kEvalTree })
+            spec.WithGlobalFriends(path, files);
+    spec.WithGlobalRange({first, last});
+    return std::make_unique<ROOT::RDataFrame>(spec);
+}
+
+
+// Keeps the events that pass the preselection of at least one of the cut sets
+inline ROOT::RDF::RNode FilterPreselection(ROOT::RDF::RNode df, const std::vector<SelectionCuts>& cutSets,
+                                           const std::string& name) {
+    return df.Filter(
+        [cutSets](RDFColumn(crtveto) crt, RDFColumn(kine_reco_Enu) Enu, RDFColumn(shw_sp_n_20mev_showers) n20mev,
+                  RDFColumn(reco_nuvtxX) vtxX, RDFColumn(single_photon_numu_score) numu,
+                  RDFColumn(single_photon_other_score) other, RDFColumn(single_photon_ncpi0_score) ncpi0,
+                  RDFColumn(single_photon_nue_score) nue, RDFColumn(shw_sp_n_20br1_showers) n20br1) {
+            PreselectionInputs presel = { (double)crt, (double)Enu, (double)n20mev, (double)vtxX, (double)numu,
+                                          (double)other, (double)ncpi0, (double)nue, (double)n20br1 };
+            for (const SelectionCuts& cuts : cutSets)
+                if (PassesPreselection(cuts, presel)) return true;
+            return false;
+        },
+        {"crtveto", "kine_reco_Enu", "shw_sp_n_20mev_showers", "reco_nuvtxX", "single_photon_numu_score",
+         "single_photon_other_score", "single_photon_ncpi0_score", "single_photon_nue_score", "shw_sp_n_20br1_showers"},
+        name);
+}
+
+
+// Adds the columns shared by all variants to the events that pass the
+// preselection of at least one of them: the blip classification and the
+// branch level EventSummary, computed once per event for all variants.
+inline ROOT::RDF::RNode DefineEventColumns(ROOT::RDF::RNode df, const std::vector<SelectionCuts>& cutSets, float Radius) {
+
+    auto node = FilterPreselection(df, cutSets, "AnyVariant");
+
+    // --- Blip loop ---
+    // The blip columns are copied into a BlipBatch per processing slot and
+    // classified by the same kernel as the hand-written loop (blip_kernel.h)
+    struct BlipSlot {
+        BlipBatch batch;
+        BlipGeometry geo;
+    };
+    auto slots = std::make_shared<std::vector<BlipSlot>>(node.GetNSlots());
+    node = node.DefineSlot("rdf_blips",
+        [Radius, slots](unsigned int slot, RDFColumn(nblips_saved) nblips, RDFColumn(blip_x) bx, RDFColumn(blip_y) by,
+                        RDFColumn(blip_z) bz, RDFColumn(blip_energy) energy, RDFColumn(blip_nplanes) nplanes,
+                        RDFColumn(blip_touchtrk) touchtrk, RDFColumn(blip_pl2_bydeadwire) bydeadwire,
+                        RDFColumn(blip_proxtrkdist) proxtrkdist, RDFColumn(blip_true_g4id) g4id,
+                        RDFColumn(blip_true_pdg) pdg,
+                        RDFColumn(reco_showervtxX) shX, RDFColumn(reco_showervtxY) shY, RDFColumn(reco_showervtxZ) shZ,
+                        RDFColumn(reco_showerMomentum) shMom) {
+
+            BlipBatch& batch = (*slots)[slot].batch;
+            BlipGeometry& geo = (*slots)[slot].geo;
+            batch.Fill(nblips > 0 ? (size_t)nblips : 0, bx, by, bz, energy, nplanes, touchtrk, bydeadwire,
+                       proxtrkdist, g4id, pdg);
+            ClassifyBlips(batch, TVector3(shX, shY, shZ), TVector3(shMom[0], shMom[1], shMom[2]), Radius, geo);
+
+            BlipColumns blips;
+            blips.energy.assign(batch.energy.data(), batch.energy.data() + batch.n);
+            blips.dist2vtx.assign(geo.dist2vtx.data(), geo.dist2vtx.data() + geo.n);
+            blips.angle.assign(geo.angle.data(), geo.angle.data() + geo.n);
+            blips.cosangle.assign(geo.cosangle.data(), geo.cosangle.data() + geo.n);
+            blips.flags.assign(geo.flags.data(), geo.flags.data() + geo.n);
+            return blips;
+        },
+        {"nblips_saved", "blip_x", "blip_y", "blip_z", "blip_energy", "blip_nplanes", "blip_touchtrk",
+         "blip_pl2_bydeadwire", "blip_proxtrkdist", "blip_true_g4id", "blip_true_pdg",
+         "reco_showervtxX", "reco_showervtxY", "reco_showervtxZ", "reco_showerMomentum"});
+
+    // One column per blip population and variable, holding the values to histogram
+    for (int iGroup = 0; iGroup < kNBlipGroups; ++iGroup) {
+        int mask = kBlipGroups[iGroup].mask, value = kBlipGroups[iGroup].value;
+        std::string group = "rdf_blipgroup" + std::to_string(iGroup) + "_";
+
+        node = node.Define(group + "energy",
+            [mask, value](const BlipColumns& blips) {
+                ROOT::RVec<float> out;
+                for (size_t i = 0; i < blips.flags.size(); ++i)
+                    if ((blips.flags[i] & mask) == value) out.push_back(blips.energy[i]);
+                return out;
+            }, {"rdf_blips"});
+        node = node.Define(group + "dist2vtx",
+            [mask, value](const BlipColumns& blips) {
+                ROOT::RVec<float> out;
+                for (size_t i = 0; i < blips.flags.size(); ++i)
+                    if ((blips.flags[i] & mask) == value) out.push_back(blips.dist2vtx[i]);
+                return out;
+            }, {"rdf_blips"});
+        node = node.Define(group + "angle",
+            [mask, value](const BlipColumns& blips) {
+                ROOT::RVec<double> out;
+                for (size_t i = 0; i < blips.flags.size(); ++i)
+                    if ((blips.flags[i] & mask) == value) out.push_back(blips.angle[i]);
+                return out;
+            }, {"rdf_blips"});
+        node = node.Define(group + "cosangle",
+            [mask, value](const BlipColumns& blips) {
+                ROOT::RVec<double> out;
+                for (size_t i = 0; i < blips.flags.size(); ++i)
+                    if ((blips.flags[i] & mask) == value) out.push_back(blips.cosangle[i]);
+                return out;
+            }, {"rdf_blips"});
+    }
+
+    // Signal blip multiplicity and summed energy (summed in blip order, as a float)
+    node = node.Define("rdf_n_sig_all_blips",
+        [](const BlipColumns& blips) {
+            int n = 0;
+            for (int flags : blips.flags) if (flags & kBlipSignal) n++;
+            return n;
+        }, {"rdf_blips"});
+    node = node.Define("rdf_n_sig_all_regB_blips",
+        [](const BlipColumns& blips) {
+            int n = 0;
+            for (int flags : blips.flags) if ((flags & kBlipSignal) && (flags & kBlipRegB)) n++;
+            return n;
+        }, {"rdf_blips"});
+    node = node.Define("rdf_SumE_sig_all_blips",
+        [](const BlipColumns& blips) {
+            float sum = 0;
+            for (size_t i = 0; i < blips.flags.size(); ++i) if (blips.flags[i] & kBlipSignal) sum += blips.energy[i];
+            return sum;
+        }, {"rdf_blips"});
+    node = node.Define("rdf_is_0n",
+        [](int n_sig_all_blips, float SumE_sig_all_blips) { return Is0n(n_sig_all_blips, SumE_sig_all_blips); },
+        {"rdf_n_sig_all_blips", "rdf_SumE_sig_all_blips"});
+
+    // --- Protons ---
+    // Get_Nproton/is_0p take the kine arrays by pointer: give them a copy laid
+    // out like the set_vars buffers.
+    using KineE    = std::remove_all_extents<decltype(kine_energy_particle)>::type;
+    using KineType = std::remove_all_extents<decltype(kine_particle_type)>::type;
+    const size_t kMaxKine = std::extent<decltype(kine_energy_particle)>::value;
+
+    // WC protons, 0p and truth category in one EventSummary (event_summary.h),
+    // so the kine arrays are copied and scanned once per event
+    node = node.Define("rdf_event",
+        [kMaxKine](RDFColumn(numu_cc_flag) flag, RDFColumn(kine_energy_particle) energy, RDFColumn(kine_particle_type) type,
+                   RDFColumn(match_completeness_energy) match_completeness_energy, RDFColumn(truth_energyInside) truth_energyInside,
+                   RDFColumn(truth_single_photon) truth_single_photon, RDFColumn(truth_isCC) truth_isCC,
+                   RDFColumn(truth_NCDelta) truth_NCDelta, RDFColumn(truth_vtxInside) truth_vtxInside,
+                   RDFColumn(truth_showerMother) truth_showerMother, RDFColumn(truth_nuPdg) truth_nuPdg,
+                   RDFColumn(truth_muonMomentum) truth_muonMomentum, RDFColumn(truth_Npi0) truth_Npi0) {
+            std::vector<KineE> e(kMaxKine, 0);
+            std::vector<KineType> t(kMaxKine, 0);
+            std::copy(energy.begin(), energy.begin() + std::min(energy.size(), kMaxKine), e.begin());
+            std::copy(type.begin(), type.begin() + std::min(type.size(), kMaxKine), t.begin());
+            EventSummary summary;
+            summary.WC_N_rec_protons = Get_Nproton(flag, e.data(), t.data());
+            summary.is0p             = is_0p(flag, e.data(), t.data());
+            summary.category         = ClassifyTruth({ match_completeness_energy, truth_energyInside, truth_single_photon, truth_isCC,
+                                                       truth_NCDelta, truth_vtxInside, truth_showerMother, truth_nuPdg,
+                                                       truth_muonMomentum[3], truth_Npi0 });
+            return summary;
+        },
+        {"numu_cc_flag", "kine_energy_particle", "kine_particle_type",
+         "match_completeness_energy", "truth_energyInside", "truth_single_photon", "truth_isCC", "truth_NCDelta",
+         "truth_vtxInside", "truth_showerMother", "truth_nuPdg", "truth_muonMomentum", "truth_Npi0"});
+    node = node.Define("rdf_WC_N_rec_protons", [](const EventSummary& event) { return event.WC_N_rec_protons; }, {"rdf_event"});
+    node = node.Define("rdf_is_0p",            [](const EventSummary& event) { return event.is0p; },             {"rdf_event"});
+
+    // --- Truth categories: SPCategory, kNoSPCategory (-1) for neither ---
+    node = node.Define("rdf_sp_category", [](const EventSummary& event) { return (int)event.category; }, {"rdf_event"});
+
+    return node;
+}
+
+
+// Events of one variant, with the only column that depends on it,
+// rdf_N_rec_protons + tag (tagged so several variants can be booked on one
+// graph). All the other columns come from DefineEventColumns and are shared,
+// untagged, by every variant.
+inline ROOT::RDF::RNode DefineSelectionColumns(ROOT::RDF::RNode events, const SelectionVariant& variant,
+                                               const std::string& tag) {
+
+    // --- Preselection: same threshold table as the hand-written loop ---
+    auto node = FilterPreselection(events, {variant.cuts}, variant.label);
+
+    bool AddBacktrackedBlips = variant.AddBacktrackedBlips;
+    node = node.Define("rdf_N_rec_protons" + tag,
+        [AddBacktrackedBlips](int WC_N_rec_protons, int n_sig_all_regB_blips) {
+            return AddBacktrackedBlips ? WC_N_rec_protons + n_sig_all_regB_blips : WC_N_rec_protons;
+        }, {"rdf_WC_N_rec_protons", "rdf_n_sig_all_regB_blips"});
+
+    return node;
+}
+
+#endif
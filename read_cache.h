@@ -0,0 +1,202 @@
+// Read-ahead of the input trees (--cache, --prefetch).
+//
+// The five trees are read in lockstep, entry by entry, and every active
+// branch has its own baskets: without a cache set up for them each basket is
+// a small read of its own, which is fine on a local disk but slow on /pnfs.
+// With --cache MB every input tree (the skim tree once) gets a TTreeCache of
+// MB megabytes with the branches read for every entry registered up front, so
+// there is no learning phase, and limited to the entries the process runs:
+// one cache fill reads the baskets of all of them for the next cluster in a
+// single vectored read. With the manifest these are only the preselection
+// branches: the payload is read for the few passing entries, and caching it
+// would read the payload baskets of every entry. With --all-branches every
+// branch is read, and cached.
+// --prefetch also turns on ROOT's asynchronous prefetching, so the next
+// block is read by a helper thread while the loop works on the current one.
+//
+// At the end the hit rate of each cache (share of the basket reads served
+// from it) and the share of the prefetched baskets that were used are
+// printed, with the number of read calls on the input files. On a chain the
+// rates are taken per file, before the chain moves on to the next one.
+
+#ifndef READ_CACHE_H
+#define READ_CACHE_H
+
+#include <TDirectory.h>
+#include <TEnv.h>
+#include <TFile.h>
+#include <TParameter.h>
+#include <TString.h>
+#include <TTree.h>
+#include <TTreeCache.h>
+
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "branch_manifest.h"
+
+
+const Long64_t kDefaultCacheMB = 30;   // --prefetch without --cache
+
+
+// One input tree, summed over the files and the workers. The rates are
+// weighted by the entries read from each file.
+struct TreeCacheStats {
+    bool     cached = false;
+    Long64_t entries = 0;
+    double   hits = 0;        // hit rate * entries
+    double   used = 0;        // used/prefetched * entries
+    Long64_t fileEntries = 0; // entries read from the current file, not in the sums yet
+};
+
+struct ReadCacheSettings {
+    Long64_t bytes = -1;      // -1: ROOT's default cache, 0: no cache
+    bool     prefetch = false;
+    std::vector<TreeCacheStats> trees;   // one per InputTree
+    Long64_t fileReadCalls = 0;          // read calls on the input files, all processes
+
+    bool enabled() const { return bytes > 0; }
+};
+
+inline ReadCacheSettings gReadCache;
+
+
+// Cache size in MB, 0 disables the cache
+inline bool ParseCacheSize(const std::string& value, Long64_t& bytes) {
+    char* end = nullptr;
+    double mb = std::strtod(value.c_str(), &end);
+    if (value.empty() || *end != '\0' || mb < 0) {
+        std::cerr << "ERROR: --cache takes a size in MB (0: no cache), got '" << value << "'\n";
+        return false;
+    }
+    bytes = (Long64_t)(mb * 1024 * 1024);
+    return true;
+}
+
+// Before the input files are opened: a cache made afterwards prefetches
+inline void EnableAsyncPrefetching() {
+    gEnv->SetValue("TFile.AsyncPrefetching", 1);
+}
+
+
+// After OpenInput(), before the loop over the entries [first, last) of a process
+inline void SetUpReadCache(std::vector<InputTree>& inputs, bool UseBranchManifest, Long64_t first, Long64_t last) {
+    if (gReadCache.bytes < 0) return;
+    gReadCache.trees.resize(inputs.size());
+    for (size_t k = 0; k < inputs.size(); ++k) {
+        TTree* tree = inputs[k].tree;
+        bool done = false;
+        for (size_t j = 0; j < k; ++j) done = done || inputs[j].tree == tree;
+        if (done) continue;
+
+        tree->SetCacheSize(gReadCache.bytes);
+        if (gReadCache.bytes == 0) continue;
+        // A chain has no cache before its first file is loaded. The Wire-Cell
+        // trees of a filtered input are read through the entry map: no range
+        bool mapped = !inputs[k].entryMap.empty();
+        tree->LoadTree(mapped || first >= last ? 0 : first);
+
+        // The preselection branches of every InputTree reading this tree (all five on a skim)
+        if (UseBranchManifest) {
+            for (const InputTree& in : inputs)
+                if (in.tree == tree)
+                    for (const ManifestEntry& entry : BranchManifest())
+                        if (entry.stage == kStagePreselection && std::string(in.path) == entry.tree &&
+                            tree->GetBranch(entry.branch))
+                            tree->AddBranchToCache(entry.branch, true);
+        } else {
+            tree->AddBranchToCache("*", true);
+        }
+        tree->StopCacheLearningPhase();
+        if (!mapped) tree->SetCacheEntryRange(first, last);
+        gReadCache.trees[k].cached = true;
+    }
+}
+
+// Adds the rates of the cache of the current file of tree k
+inline void AddFileCacheStats(TTree* tree, TreeCacheStats& stats) {
+    TTreeCache* cache = dynamic_cast<TTreeCache*>(tree->GetReadCache(tree->GetCurrentFile()));
+    if (cache) {
+        stats.entries += stats.fileEntries;
+        stats.hits    += cache->GetEfficiencyRel() * stats.fileEntries;
+        stats.used    += cache->GetEfficiency() * stats.fileEntries;
+    }
+    stats.fileEntries = 0;
+}
+
+// Before the reads of loop entry `entry`: takes the rates of a file before a
+// chain leaves it, then counts the entry
+inline void CountCacheEntry(const std::vector<InputTree>& inputs, Long64_t entry) {
+    for (size_t k = 0; k < inputs.size() && k < gReadCache.trees.size(); ++k) {
+        TreeCacheStats& stats = gReadCache.trees[k];
+        if (!stats.cached) continue;
+        TTree* tree = inputs[k].tree;
+        TTree* current = tree->GetTree();
+        Long64_t local = TreeEntry(inputs[k], entry) - tree->GetChainOffset();
+        if (current && stats.fileEntries > 0 && (local < 0 || local >= current->GetEntries()))
+            AddFileCacheStats(tree, stats);
+        stats.fileEntries++;
+    }
+}
+
+// After the loop of a process: the rates of the last file
+inline void CollectCacheStats(const std::vector<InputTree>& inputs) {
+    if (!gReadCache.enabled()) return;
+    for (size_t k = 0; k < inputs.size() && k < gReadCache.trees.size(); ++k)
+        if (gReadCache.trees[k].cached) AddFileCacheStats(inputs[k].tree, gReadCache.trees[k]);
+}
+
+
+// Worker shard io/ directory
+inline void WriteCacheStats(TDirectory* io) {
+    io->cd();
+    for (size_t k = 0; k < gReadCache.trees.size(); ++k) {
+        const TreeCacheStats& s = gReadCache.trees[k];
+        TParameter<Long64_t>(Form("cacheEntries_%zu", k), s.entries).Write();
+        TParameter<double>(Form("cacheHits_%zu", k), s.hits).Write();
+        TParameter<double>(Form("cacheUsed_%zu", k), s.used).Write();
+    }
+}
+
+inline void MergeCacheStats(TDirectory* io, size_t nTrees) {
+    gReadCache.trees.resize(nTrees);
+    for (size_t k = 0; k < nTrees; ++k) {
+        TreeCacheStats& s = gReadCache.trees[k];
+        TParameter<Long64_t>* entries = nullptr;
+        TParameter<double>* hits = nullptr, *used = nullptr;
+        io->GetObject(Form("cacheEntries_%zu", k), entries);
+        io->GetObject(Form("cacheHits_%zu", k), hits);
+        io->GetObject(Form("cacheUsed_%zu", k), used);
+        if (!entries || entries->GetVal() == 0) continue;
+        s.cached   = true;
+        s.entries += entries->GetVal();
+        if (hits) s.hits += hits->GetVal();
+        if (used) s.used += used->GetVal();
+    }
+}
+
+
+inline void PrintCacheReport(const std::vector<InputTree>& inputs) {
+    std::cout << "\n ---- READ CACHE ----\n";
+    if (gReadCache.enabled())
+        std::cout << " TTreeCache " << gReadCache.bytes / (1024 * 1024.) << " MB per tree"
+                  << (gReadCache.prefetch ? ", asynchronous prefetching" : "") << "\n";
+    else
+        std::cout << " No TTreeCache\n";
+    for (size_t k = 0; k < inputs.size() && k < gReadCache.trees.size(); ++k) {
+        const TreeCacheStats& s = gReadCache.trees[k];
+        if (!s.cached || s.entries == 0) continue;
+        std::cout << " " << std::left << std::setw(38) << inputs[k].path << std::right << std::fixed << std::setprecision(1)
+                  << " hit rate " << std::setw(5) << 100 * s.hits / s.entries << " %"
+                  << "  prefetched baskets used " << std::setw(5) << 100 * s.used / s.entries << " %\n";
+        std::cout.unsetf(std::ios::floatfield);
+        std::cout << std::setprecision(6);
+    }
+    std::cout << " File read calls: " << gReadCache.fileReadCalls << "\n";
+    std::cout << " --------------------\n";
+}
+
+#endif
@@ -1,57 +1,38 @@
 #!/bin/bash
 
-# ./anamacro_1gX_blips_sideband <input_file> <Signal/Sideband> <IsData> <AddBacktrkBlips> <OutDir>
-
-#BNB Nu overlay
-./anamacro_1gX_blips_sideband /path/to/file/BNB/MCC9.10_Run4b_v10_04_07_09_BNB_nu_overlay_surprise_reco2_hist.root Sideband false false SIDEBAND
-
-
-
-#BNB-ON
-./anamacro_1gX_blips_sideband /path/to/file/BNB/MCC9.10_Run4b_v10_04_07_11_BNB_beam_on_surprise_reco2_hist.root Sideband true false SIDEBAND
-
-
-#BNB-OFF
-./anamacro_1gX_blips_sideband /path/to/file/BNB/MCC9.10_Run4b_v10_04_07_09_Run4b_BNB_beam_off_surprise_reco2_hist.root Sideband false false SIDEBAND
-
-
-#BNB Nue overlay
-./anamacro_1gX_blips_sideband /path/to/file/BNB/MCC9.10_Run4b_v10_04_07_09_BNB_nue_overlay_surprise_reco2_hist.root Sideband false false SIDEBAND
-
-
-#Pi0
-./anamacro_1gX_blips_sideband /path/to/file/BNB/MCC9.10_Run4b_v10_04_07_09_BNB_NC_pi0_overlay_surprise_reco2_hist.root Sideband false false SIDEBAND
-
-
-#DIRT
-./anamacro_1gX_blips_sideband /path/to/file/BNB/MCC9.10_Run4b_v10_04_07_09_BNB_dirt_surpise_reco2_hist.root Sideband false false SIDEBAND
+# Sideband-only run. The sideband cuts are selected by the label, so this uses
+# the same executable as the signal selection (see run_anamacro_1gX_blips_signal.sh
+# to fill signal and sideband in a single read).
+#
+# ./anamacro_1gX_blips_signal <input_file> <IsData> --variant <Signal/Sideband>,<AddBacktrkBlips>,<OutDir> [--variant ...]
 
+VARIANTS="--variant Sideband,false,SIDEBAND --variant SidebandBTB,true,SIDEBAND_BTB"
 
-
-#Adding proton blips candidates 
+# Set STAGE_DIR (e.g. /scratch/$USER/reco2_stage) to read local copies of the
+# inputs, staged there by the first job that needs them (stage_cache.h)
+STAGE=${STAGE_DIR:+--stage-dir $STAGE_DIR --stage-limit ${STAGE_LIMIT_GB:-100}}
 
 #BNB Nu overlay
-./anamacro_1gX_blips_sideband /path/to/file/BNB/MCC9.10_Run4b_v10_04_07_09_BNB_nu_overlay_surprise_reco2_hist.root SidebandBTB false true SIDEBAND_BTB
+./anamacro_1gX_blips_signal /path/to/file/BNB/MCC9.10_Run4b_v10_04_07_09_BNB_nu_overlay_surprise_reco2_hist.root false $VARIANTS $STAGE
 
 
 
 #BNB-ON
-./anamacro_1gX_blips_sideband /path/to/file/BNB/MCC9.10_Run4b_v10_04_07_11_BNB_beam_on_surprise_reco2_hist.root SidebandBTB true true SIDEBAND_BTB
+./anamacro_1gX_blips_signal /path/to/file/BNB/MCC9.10_Run4b_v10_04_07_11_BNB_beam_on_surprise_reco2_hist.root true $VARIANTS $STAGE
 
 
 #BNB-OFF
-./anamacro_1gX_blips_sideband /path/to/file/BNB/MCC9.10_Run4b_v10_04_07_09_Run4b_BNB_beam_off_surprise_reco2_hist.root SidebandBTB false true SIDEBAND_BTB
+./anamacro_1gX_blips_signal /path/to/file/BNB/MCC9.10_Run4b_v10_04_07_09_Run4b_BNB_beam_off_surprise_reco2_hist.root false $VARIANTS $STAGE
 
 
 #BNB Nue overlay
-./anamacro_1gX_blips_sideband /path/to/file/BNB/MCC9.10_Run4b_v10_04_07_09_BNB_nue_overlay_surprise_reco2_hist.root SidebandBTB false true SIDEBAND_BTB
+./anamacro_1gX_blips_signal /path/to/file/BNB/MCC9.10_Run4b_v10_04_07_09_BNB_nue_overlay_surprise_reco2_hist.root false $VARIANTS $STAGE
 
 
 #Pi0
-./anamacro_1gX_blips_sideband /path/to/file/BNB/MCC9.10_Run4b_v10_04_07_09_BNB_NC_pi0_overlay_surprise_reco2_hist.root SidebandBTB false true SIDEBAND_BTB
+./anamacro_1gX_blips_signal /path/to/file/BNB/MCC9.10_Run4b_v10_04_07_09_BNB_NC_pi0_overlay_surprise_reco2_hist.root false $VARIANTS $STAGE
 
 
 #DIRT
-./anamacro_1gX_blips_sideband /path/to/file/BNB/MCC9.10_Run4b_v10_04_07_09_BNB_dirt_surpise_reco2_hist.root SidebandBTB false true SIDEBAND_BTB
-
+./anamacro_1gX_blips_signal /path/to/file/BNB/MCC9.10_Run4b_v10_04_07_09_BNB_dirt_surpise_reco2_hist.root false $VARIANTS $STAGE
 
@@ -1,67 +1,44 @@
 #!/bin/bash
 
 # ./anamacro_1gX_blips_signal <input_file> <Signal/Sideband> <IsData> <AddBacktrkBlips> <OutDir>
+# ./anamacro_1gX_blips_signal <input_file> <IsData> --variant <Signal/Sideband>,<AddBacktrkBlips>,<OutDir> [--variant ...]
+#
+# Each sample is read once; signal, sideband and the backtracked-blip (BTB)
+# variants are all filled in the same event loop.
+
+VARIANTS="--variant Signal,false,SIGNAL --variant SignalBTB,true,SIGNAL_BTB --variant Sideband,false,SIDEBAND --variant SidebandBTB,true,SIDEBAND_BTB"
+
+# Set STAGE_DIR (e.g. /scratch/$USER/reco2_stage) to read local copies of the
+# inputs, staged there by the first job that needs them (stage_cache.h)
+STAGE=${STAGE_DIR:+--stage-dir $STAGE_DIR --stage-limit ${STAGE_LIMIT_GB:-100}}
 
 
 #run4b EXT unbiased 
 
-<<<<<<< HEAD
 ./anamacro_1gX_blips_signal_EXTUnb /path/to/file/surprise/run4b_full_samples/wc_processed/BNB/checkout_MCC9.10_Run4b_BNB_extunbiased_data_surprise_reco2_hist.root Signal true false SIGNAL_EXTUnb
-=======
-./anamacro_1gX_blips_signal_EXTUnb /pnfs/uboone/persistent/users/uboonepro/surprise/run4b_full_samples/wc_processed/BNB/checkout_MCC9.10_Run4b_BNB_extunbiased_data_surprise_reco2_hist.root Signal true false SIGNAL_EXTUnb
->>>>>>> 40cccb8144cf9b941335a90dc770c558df1539aa
 
 
 #BNB Nu overlay
-./anamacro_1gX_blips_signal /path/to/file/BNB/MCC9.10_Run4b_v10_04_07_09_BNB_nu_overlay_surprise_reco2_hist.root Signal false false SIGNAL
+./anamacro_1gX_blips_signal /path/to/file/BNB/MCC9.10_Run4b_v10_04_07_09_BNB_nu_overlay_surprise_reco2_hist.root false $VARIANTS $STAGE
 ./anamacro_1gX_blips_signal_enhanced /path/to/file/BNB/MCC9.10_Run4b_v10_04_07_09_BNB_nu_overlay_surprise_reco2_hist.root Signal false false SIGNAL_ENHANCED
 
 
 #BNB-ON
-./anamacro_1gX_blips_signal /path/to/file/BNB/MCC9.10_Run4b_v10_04_07_11_BNB_beam_on_surprise_reco2_hist.root Signal true false SIGNAL
+./anamacro_1gX_blips_signal /path/to/file/BNB/MCC9.10_Run4b_v10_04_07_11_BNB_beam_on_surprise_reco2_hist.root true $VARIANTS $STAGE
 ./anamacro_1gX_blips_signal_enhanced /path/to/file/BNB/MCC9.10_Run4b_v10_04_07_11_BNB_beam_on_surprise_reco2_hist.root Signal true false SIGNAL_ENHANCED_BNBoN
 
 #BNB-OFF
-./anamacro_1gX_blips_signal /path/to/file/BNB/MCC9.10_Run4b_v10_04_07_09_Run4b_BNB_beam_off_surprise_reco2_hist.root Signal false false SIGNAL
-
-
-#BNB Nue overlay
-./anamacro_1gX_blips_signal /path/to/file/BNB/MCC9.10_Run4b_v10_04_07_09_BNB_nue_overlay_surprise_reco2_hist.root Signal false false SIGNAL
-
-
-#Pi0
-./anamacro_1gX_blips_signal /path/to/file/BNB/MCC9.10_Run4b_v10_04_07_09_BNB_NC_pi0_overlay_surprise_reco2_hist.root Signal false false SIGNAL
-
-
-#DIRT
-./anamacro_1gX_blips_signal /path/to/file/BNB/MCC9.10_Run4b_v10_04_07_09_BNB_dirt_surpise_reco2_hist.root Signal false false SIGNAL
-
-
-
-#Adding proton blips candidates 
-
-#BNB Nu overlay
-./anamacro_1gX_blips_signal /path/to/file/BNB/MCC9.10_Run4b_v10_04_07_09_BNB_nu_overlay_surprise_reco2_hist.root SignalBTB false true SIGNAL_BTB
-
-
-
-#BNB-ON
-./anamacro_1gX_blips_signal /path/to/file/BNB/MCC9.10_Run4b_v10_04_07_11_BNB_beam_on_surprise_reco2_hist.root SignalBTB true true SIGNAL_BTB
-
-
-#BNB-OFF
-./anamacro_1gX_blips_signal /path/to/file/BNB/MCC9.10_Run4b_v10_04_07_09_Run4b_BNB_beam_off_surprise_reco2_hist.root SignalBTB false true SIGNAL_BTB
+./anamacro_1gX_blips_signal /path/to/file/BNB/MCC9.10_Run4b_v10_04_07_09_Run4b_BNB_beam_off_surprise_reco2_hist.root false $VARIANTS $STAGE
 
 
 #BNB Nue overlay
-./anamacro_1gX_blips_signal /path/to/file/BNB/MCC9.10_Run4b_v10_04_07_09_BNB_nue_overlay_surprise_reco2_hist.root SignalBTB false true SIGNAL_BTB
+./anamacro_1gX_blips_signal /path/to/file/BNB/MCC9.10_Run4b_v10_04_07_09_BNB_nue_overlay_surprise_reco2_hist.root false $VARIANTS $STAGE
 
 
 #Pi0
-./anamacro_1gX_blips_signal /path/to/file/BNB/MCC9.10_Run4b_v10_04_07_09_BNB_NC_pi0_overlay_surprise_reco2_hist.root SignalBTB false true SIGNAL_BTB
+./anamacro_1gX_blips_signal /path/to/file/BNB/MCC9.10_Run4b_v10_04_07_09_BNB_NC_pi0_overlay_surprise_reco2_hist.root false $VARIANTS $STAGE
 
 
 #DIRT
-./anamacro_1gX_blips_signal /path/to/file/BNB/MCC9.10_Run4b_v10_04_07_09_BNB_dirt_surpise_reco2_hist.root SignalBTB false true SIGNAL_BTB
-
+./anamacro_1gX_blips_signal /path/to/file/BNB/MCC9.10_Run4b_v10_04_07_09_BNB_dirt_surpise_reco2_hist.root false $VARIANTS $STAGE
 
@@ -0,0 +1,86 @@
+#!/bin/bash
+
+# Event loop benchmark on synthetic input (make_synthetic_input.cpp).
+#
+# bash run_benchmark.sh [events] [threads]
+#
+# Builds anamacro_1gX_blips_signal and make_synthetic_input, writes a synthetic
+# MC file and runs the signal/sideband variants on it with the serial loop, the
+# forked workers (--threads), and the RDataFrame engine (serial and implicit MT).
+# For each it prints the wall time, events/s, input blips/s and peak RSS
+# (with --threads, the largest of the parent and its workers).
+#
+# Then the serial loop runs without a TTreeCache and with --cache/--prefetch
+# (read_cache.h). On a local disk the reads are cheap, so the time each would
+# take on a remote input is modelled as wall time + read calls x LATENCY_MS.
+#
+# BLIPS, SIGNAL_PASS, SIDEBAND_PASS, LATENCY_MS and BENCH_DIR can be set in the
+# environment.
+
+EVENTS=${1:-100000}
+THREADS=${2:-4}
+BLIPS=${BLIPS:-poisson:40}
+SIGNAL_PASS=${SIGNAL_PASS:-0.05}
+SIDEBAND_PASS=${SIDEBAND_PASS:-0.05}
+LATENCY_MS=${LATENCY_MS:-5}
+BENCH_DIR=${BENCH_DIR:-benchmark}
+
+SRC=$(cd "$(dirname "$0")" && pwd)
+VARIANTS="--variant Signal,false,SIGNAL --variant SignalBTB,true,SIGNAL_BTB --variant Sideband,false,SIDEBAND"
+
+set -e
+mkdir -p $BENCH_DIR
+cd $BENCH_DIR
+
+g++ -O2 $SRC/anamacro_1gX_blips_signal.cpp -o anamacro_1gX_blips_signal $(root-config --cflags --libs)
+g++ -O2 $SRC/make_synthetic_input.cpp -o make_synthetic_input $(root-config --cflags --libs)
+
+./make_synthetic_input synthetic_${EVENTS}.root --events $EVENTS --blips $BLIPS \
+    --signal-pass $SIGNAL_PASS --sideband-pass $SIDEBAND_PASS | tee make_synthetic_input.log
+NBLIPS=$(sed -n 's/.* events, \([0-9]*\) blips.*/\1/p' make_synthetic_input.log)
+set +e
+
+# name, options
+run() {
+    local name=$1
+    shift
+    rm -rf SIGNAL SIGNAL_BTB SIDEBAND
+    /usr/bin/time -f "%e %M" -o time_$name.txt ./anamacro_1gX_blips_signal synthetic_${EVENTS}.root false $VARIANTS "$@" > $name.log 2>&1
+    if [ $? -ne 0 ]; then
+        printf "%-12s FAILED, see %s/%s.log\n" $name $BENCH_DIR $name
+        return
+    fi
+    read seconds rss < time_$name.txt
+    awk -v n=$name -v s=$seconds -v r=$rss -v e=$EVENTS -v b=$NBLIPS \
+        'BEGIN { printf "%-12s %10.2f %12.0f %14.0f %12.1f\n", n, s, e / s, b / s, r / 1024 }'
+}
+
+echo
+printf "%-12s %10s %12s %14s %12s\n" engine "wall [s]" "events/s" "blips/s" "peak RSS [MB]"
+run serial
+run threads$THREADS --threads $THREADS
+run rdf --engine rdf
+run rdf_mt$THREADS --engine rdf --threads $THREADS
+
+# name, options: read calls and time with LATENCY_MS per read call
+run_cache() {
+    local name=$1
+    shift
+    rm -rf SIGNAL SIGNAL_BTB SIDEBAND
+    /usr/bin/time -f "%e %M" -o time_$name.txt ./anamacro_1gX_blips_signal synthetic_${EVENTS}.root false $VARIANTS "$@" > $name.log 2>&1
+    if [ $? -ne 0 ]; then
+        printf "%-12s FAILED, see %s/%s.log\n" $name $BENCH_DIR $name
+        return
+    fi
+    read seconds rss < time_$name.txt
+    calls=$(sed -n 's/ *File read calls: \([0-9]*\)/\1/p' $name.log)
+    hits=$(sed -n 's/.*NeutrinoSelectionFilter.*hit rate *\([0-9.]*\) %.*/\1/p' $name.log)
+    awk -v n=$name -v s=$seconds -v c=$calls -v l=$LATENCY_MS -v h=${hits:--} \
+        'BEGIN { printf "%-12s %10.2f %12d %14s %22.2f\n", n, s, c, h, s + c * l / 1000 }'
+}
+
+echo
+printf "%-12s %10s %12s %14s %22s\n" cache "wall [s]" "read calls" "PeLEE hit [%]" "at ${LATENCY_MS} ms/read [s]"
+run_cache nocache --cache 0
+run_cache cache --cache 30
+run_cache prefetch --cache 30 --prefetch
@@ -0,0 +1,147 @@
+// Cut sets and selection variants for the 1gX preselection.
+//
+// The signal and sideband selections only differ in the BDT score windows and
+// in the shw_sp_n_20br1_showers requirement, so both are expressed here as
+// threshold tables. A "variant" is a cut set plus the bookkeeping that used to
+// be passed on the command line (label, AddBacktrkBlips, output directory), so
+// several variants can be evaluated on the same event inside one read.
+
+#ifndef SELECTION_VARIANTS_H
+#define SELECTION_VARIANTS_H
+
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+
+// Scalars the preselection looks at, copied out of the branch variables once
+// per event so every variant reads the same values.
+struct PreselectionInputs {
+    double crtveto;
+    double kine_reco_Enu;
+    double shw_sp_n_20mev_showers;
+    double reco_nuvtxX;
+    double single_photon_numu_score;
+    double single_photon_other_score;
+    double single_photon_ncpi0_score;
+    double single_photon_nue_score;
+    double shw_sp_n_20br1_showers;
+};
+
+
+// BDT score window and topology requirement of one selection.
+// A bound set to +/-infinity is not applied at all (the sideband has no nue
+// cut and no upper ncpi0 cut in the signal selection).
+struct SelectionCuts {
+    std::string name;
+    double numu_score_min;
+    double other_score_min;
+    double ncpi0_score_min;
+    double ncpi0_score_max;
+    double nue_score_min;
+    bool   require_one_20br1_shower;
+};
+
+const double kNoCut = std::numeric_limits<double>::infinity();
+
+// 1gX signal selection
+const SelectionCuts kSignalCuts   = {"Signal",    0.4,  0.2, -0.05,  kNoCut, -1.0,   true};
+// NC pi0 sideband
+const SelectionCuts kSidebandCuts = {"Sideband",  0.1, -0.4, -20.0,  -0.4,   -kNoCut, false};
+
+
+// Preselection cuts, in the order they are applied (cut flow: cut_flow.h)
+enum PreselectionCut {
+    kCutCRTVeto = 0, kCutEnu, kCut20MeVShowers, kCutVtxX,
+    kCutNumuScore, kCutOtherScore, kCutNcpi0ScoreMin, kCutNcpi0ScoreMax, kCutNueScore,
+    kCut20br1Showers,
+    kNPreselectionCuts
+};
+
+const char* const kPreselectionCutNames[kNPreselectionCuts] = {
+    "crtveto", "kine_reco_Enu", "shw_sp_n_20mev_showers", "reco_nuvtxX",
+    "numu_score", "other_score", "ncpi0_score_min", "ncpi0_score_max", "nue_score",
+    "shw_sp_n_20br1_showers"
+};
+
+// First cut the event fails, kNPreselectionCuts if it passes them all.
+// A bound that is not applied counts as passed.
+inline int FirstFailedCut(const SelectionCuts& cuts, const PreselectionInputs& in) {
+
+    // generic neutrino selection, shared by every variant
+    if (!(in.crtveto == 0))                                       return kCutCRTVeto;
+    if (!(in.kine_reco_Enu > 0))                                  return kCutEnu;
+    if (!(in.shw_sp_n_20mev_showers > 0))                         return kCut20MeVShowers;
+    if (!(in.reco_nuvtxX > 5.0 && in.reco_nuvtxX < 250.0))        return kCutVtxX;
+
+    // BDT score window
+    if (!(in.single_photon_numu_score  > cuts.numu_score_min))  return kCutNumuScore;
+    if (!(in.single_photon_other_score > cuts.other_score_min)) return kCutOtherScore;
+    if (!(in.single_photon_ncpi0_score > cuts.ncpi0_score_min)) return kCutNcpi0ScoreMin;
+    if (!std::isinf(cuts.ncpi0_score_max) && !(in.single_photon_ncpi0_score < cuts.ncpi0_score_max)) return kCutNcpi0ScoreMax;
+    if (!std::isinf(cuts.nue_score_min)   && !(in.single_photon_nue_score   > cuts.nue_score_min))   return kCutNueScore;
+
+    if (cuts.require_one_20br1_shower && !(in.shw_sp_n_20br1_showers == 1)) return kCut20br1Showers;
+
+    return kNPreselectionCuts;
+}
+
+inline bool PassesPreselection(const SelectionCuts& cuts, const PreselectionInputs& in) {
+    return FirstFailedCut(cuts, in) == kNPreselectionCuts;
+}
+
+// The thresholds of a cut set on one line (selection_config, skim.h)
+inline std::string DescribeCuts(const SelectionCuts& cuts) {
+    std::ostringstream line;
+    line << cuts.name << " numu>" << cuts.numu_score_min << " other>" << cuts.other_score_min
+         << " ncpi0>" << cuts.ncpi0_score_min << " ncpi0<" << cuts.ncpi0_score_max << " nue>" << cuts.nue_score_min
+         << " one20br1=" << cuts.require_one_20br1_shower;
+    return line.str();
+}
+
+
+// One selection evaluated in the event loop, written to its own output file.
+struct SelectionVariant {
+    std::string   label;                // Signal, SignalBTB, Sideband, SidebandBTB
+    SelectionCuts cuts;
+    bool          AddBacktrackedBlips;
+    std::string   outDir;
+};
+
+
+// Labels starting with "Signal" use the signal cuts, labels starting with
+// "Sideband" the sideband cuts (so SignalBTB, Sideband_CRT, ... keep working).
+inline bool CutsForLabel(const std::string& label, SelectionCuts& cuts) {
+    if (label.rfind("Sideband", 0) == 0) { cuts = kSidebandCuts; return true; }
+    if (label.rfind("Signal", 0) == 0)   { cuts = kSignalCuts;   return true; }
+
+    std::cerr << "ERROR: Unknown selection label '" << label
+              << "'. Expected a label starting with Signal or Sideband.\n";
+    return false;
+}
+
+
+// Parses "<label>,<AddBacktrkBlips>,<OutDir>" as given to --variant.
+inline bool ParseVariantSpec(const std::string& spec, SelectionVariant& variant,
+                             bool (*parseBool)(const std::string&)) {
+    std::vector<std::string> fields;
+    std::stringstream ss(spec);
+    std::string field;
+    while (std::getline(ss, field, ',')) fields.push_back(field);
+
+    if (fields.size() != 3) {
+        std::cerr << "ERROR: Bad --variant '" << spec
+                  << "'. Expected <label>,<AddBacktrkBlips>,<OutDir>\n";
+        return false;
+    }
+
+    variant.label = fields[0];
+    variant.AddBacktrackedBlips = parseBool(fields[1]);
+    variant.outDir = fields[2];
+    return CutsForLabel(variant.label, variant.cuts);
+}
+
+#endif
@@ -0,0 +1,354 @@
+// Merging of anamacro output files (merge_shards.cpp).
+//
+// hadd adds the histograms, but it appends the entries of the trees (the
+// evd_tree total_signal_events and one bdt_scan entry per grid point per
+// file) and knows nothing of the counters. MergeFiles() understands the
+// output format instead:
+//  - histograms (including h_cutflow_*) are added,
+//  - TParameter<Long64_t> counters (counters/, skim_source_entries) are summed,
+//  - trees are summed entry by entry, leaf by leaf, except for the leaves
+//    that identify an entry (kTreeKeyLeaves: the bdt_scan thresholds), which
+//    must be the same in every file,
+//  - selection_config (the cuts, radius, prescale, scans a file was made
+//    with) must be the same in every file.
+// The event_range/ directories are checked separately by CheckEventRanges():
+// the shards of one input must not overlap, and the merged file gets the
+// combined range.
+
+#ifndef SHARD_MERGE_H
+#define SHARD_MERGE_H
+
+#include <TDirectory.h>
+#include <TFile.h>
+#include <TH1.h>
+#include <TKey.h>
+#include <TLeaf.h>
+#include <TNamed.h>
+#include <TParameter.h>
+#include <TTree.h>
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "event_range.h"
+
+
+// Names in every output file
+const char* const kCountersDir      = "counters";
+const char* const kSelectionConfig  = "selection_config";
+
+// Leaves that identify the entries of a tree rather than count events
+const std::map<std::string, std::set<std::string>> kTreeKeyLeaves = {
+    {"bdt_scan", {"numu_score_min", "other_score_min", "ncpi0_score_min", "ncpi0_score_max",
+                  "nue_score_min", "require_one_20br1_shower"}},   // bdt_scan.h
+};
+
+
+// selection_config of a file ("" if missing)
+inline std::string ReadSelectionConfig(TDirectory* file) {
+    TNamed* config = nullptr;
+    file->GetObject(kSelectionConfig, config);
+    return config ? config->GetTitle() : "";
+}
+
+// event_range/ of a file, false if missing
+inline bool ReadEventRange(TDirectory* file, EventRangeSettings& range) {
+    TDirectory* dir = file->GetDirectory(kEventRangeDir);
+    if (!dir) return false;
+    auto get = [dir](const char* name, Long64_t& value) {
+        TParameter<Long64_t>* p = nullptr;
+        dir->GetObject(name, p);
+        if (p) value = p->GetVal();
+        return p != nullptr;
+    };
+    Long64_t shard = 0, nShards = 1;
+    TNamed* input = nullptr;
+    TParameter<double>* prescale = nullptr;
+    dir->GetObject("input", input);
+    dir->GetObject("prescale", prescale);
+    if (!input || !prescale || !get("entries", range.entries) || !get("first", range.begin) || !get("last", range.end)
+        || !get("shard", shard) || !get("nshards", nShards) || !get("accepted", range.accepted))
+        return false;
+    range.input = input->GetTitle();
+    range.prescale = prescale->GetVal();
+    range.shard = shard;
+    range.nShards = nShards;
+    return true;
+}
+
+
+// Checks that the shards of each input do not overlap and combines the
+// ranges. The result has the input and range of the shards if they are all
+// contiguous pieces of one input, otherwise an empty input and first/last -1;
+// accepted is always the sum.
+inline bool CheckEventRanges(const std::vector<std::string>& files, const std::vector<EventRangeSettings>& ranges,
+                             EventRangeSettings& merged) {
+
+    std::map<std::string, std::vector<size_t>> byInput;
+    merged = EventRangeSettings();
+    merged.prescale = ranges.empty() ? 1 : ranges[0].prescale;
+    for (size_t i = 0; i < ranges.size(); ++i) {
+        merged.accepted += ranges[i].accepted;
+        if (!ranges[i].input.empty()) byInput[ranges[i].input].push_back(i);
+    }
+
+    bool ok = true, contiguous = true;
+    for (auto& entry : byInput) {
+        std::vector<size_t>& shards = entry.second;
+        std::sort(shards.begin(), shards.end(),
+                  [&ranges](size_t a, size_t b) { return ranges[a].begin < ranges[b].begin; });
+        for (size_t k = 1; k < shards.size(); ++k) {
+            const EventRangeSettings& prev = ranges[shards[k - 1]];
+            const EventRangeSettings& cur  = ranges[shards[k]];
+            if (cur.entries != prev.entries) {
+                std::cerr << "ERROR: " << files[shards[k]] << " and " << files[shards[k - 1]] << " were made from "
+                          << entry.first << " with " << cur.entries << " and " << prev.entries << " entries\n";
+                ok = false;
+            } else if (cur.begin < prev.end) {
+                std::cerr << "ERROR: entries [" << cur.begin << ", " << std::min(cur.end, prev.end) << ") of "
+                          << entry.first << " are in both " << files[shards[k - 1]] << " and " << files[shards[k]] << "\n";
+                ok = false;
+            } else if (cur.begin > prev.end) {
+                std::cerr << "WARNING: entries [" << prev.end << ", " << cur.begin << ") of " << entry.first
+                          << " are in none of the shards\n";
+                contiguous = false;
+            }
+        }
+    }
+
+    if (byInput.size() == 1 && byInput.begin()->second.size() == ranges.size() && contiguous) {
+        const std::vector<size_t>& shards = byInput.begin()->second;
+        merged.input   = byInput.begin()->first;
+        merged.entries = ranges[shards.front()].entries;
+        merged.begin   = ranges[shards.front()].begin;
+        merged.end     = ranges[shards.back()].end;
+    } else {
+        merged.begin = merged.end = -1;
+    }
+    return ok;
+}
+
+
+// One tree, as columns of doubles
+struct MergedTree {
+    struct Column {
+        std::string name, leaflist;
+        char        type;       // leaflist type code: F, D, I, L
+        int         len;
+        bool        key;
+        std::vector<double> values;   // entry-major, len per entry
+    };
+    std::string title;
+    Long64_t entries = 0;
+    std::vector<Column> columns;
+};
+
+// Contents of one directory of the merged file, in the order first seen
+struct MergedDir {
+    struct Item {
+        std::unique_ptr<TH1>        hist;
+        Long64_t                    sum = 0;       // TParameter<Long64_t>
+        std::unique_ptr<TObject>    fixed;         // TNamed, TParameter<double>: same in every file
+        std::unique_ptr<MergedTree> tree;
+        std::unique_ptr<MergedDir>  dir;
+    };
+    std::vector<std::string> order;
+    std::map<std::string, Item> items;
+};
+
+
+// Reads the leaves of a tree, or adds them to `merged`
+inline bool MergeTree(TTree* tree, const std::string& path, MergedTree& merged, bool first) {
+
+    std::set<std::string> keys;
+    auto keyList = kTreeKeyLeaves.find(tree->GetName());
+    if (keyList != kTreeKeyLeaves.end()) keys = keyList->second;
+
+    TObjArray* leaves = tree->GetListOfLeaves();
+    if (first) {
+        merged.title = tree->GetTitle();
+        merged.entries = tree->GetEntries();
+        for (int i = 0; i < leaves->GetEntries(); ++i) {
+            TLeaf* leaf = (TLeaf*)leaves->At(i);
+            std::string leaflist = leaf->GetBranch()->GetTitle();
+            size_t slash = leaflist.rfind('/');
+            char type = slash == std::string::npos ? 'F' : leaflist[slash + 1];
+            if (leaf->GetLeafCount() || !std::strchr("FDIL", type) || leaf->GetBranch()->GetListOfLeaves()->GetEntries() != 1) {
+                std::cerr << "ERROR: " << path << ": cannot merge leaf " << leaf->GetName() << " (" << leaflist << ")\n";
+                return false;
+            }
+            merged.columns.push_back({leaf->GetName(), leaflist, type, leaf->GetLen(), keys.count(leaf->GetName()) > 0, {}});
+            merged.columns.back().values.assign(merged.entries * leaf->GetLen(), 0.);
+        }
+    } else if (tree->GetEntries() != merged.entries || leaves->GetEntries() != (int)merged.columns.size()) {
+        std::cerr << "ERROR: " << path << " has " << tree->GetEntries() << " entries and " << leaves->GetEntries()
+                  << " leaves, expected " << merged.entries << " and " << merged.columns.size() << "\n";
+        return false;
+    }
+
+    for (Long64_t entry = 0; entry < merged.entries; ++entry) {
+        tree->GetEntry(entry);
+        for (int i = 0; i < leaves->GetEntries(); ++i) {
+            TLeaf* leaf = (TLeaf*)leaves->At(i);
+            MergedTree::Column& column = merged.columns[i];
+            if (column.name != leaf->GetName() || column.len != leaf->GetLen()) {
+                std::cerr << "ERROR: " << path << ": leaf " << leaf->GetName() << " does not match " << column.name << "\n";
+                return false;
+            }
+            for (int j = 0; j < column.len; ++j) {
+                double& value = column.values[entry * column.len + j];
+                if (first || !column.key) value += leaf->GetValue(j);
+                else if (value != leaf->GetValue(j)) {
+                    std::cerr << "ERROR: " << path << ": entry " << entry << " has " << column.name << " = "
+                              << leaf->GetValue(j) << ", expected " << value << "\n";
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+
+// Adds the contents of dir (path: file:dir, for the messages) to merged. The
+// event_range/ directory of the file is skipped (CheckEventRanges).
+inline bool MergeDirectory(TDirectory* dir, const std::string& path, MergedDir& merged, bool first, bool top = true) {
+
+    std::set<std::string> seen;   // keys come highest cycle first
+    TIter next(dir->GetListOfKeys());
+    while (TKey* key = (TKey*)next()) {
+        std::string name = key->GetName();
+        if (!seen.insert(name).second) continue;
+        if (top && name == kEventRangeDir) continue;
+
+        std::string where = path + (top ? ":" : "/") + name;
+        auto found = merged.items.find(name);
+        if (!first && found == merged.items.end()) {
+            std::cerr << "ERROR: " << where << " is not in the first file\n";
+            return false;
+        }
+        if (first) merged.order.push_back(name);
+        MergedDir::Item& item = merged.items[name];
+
+        std::string className = key->GetClassName();
+        if (className == "TDirectoryFile") {
+            if (first) item.dir.reset(new MergedDir);
+            if (!item.dir || !MergeDirectory(dir->GetDirectory(name.c_str()), where, *item.dir, first, false)) return false;
+            continue;
+        }
+
+        std::unique_ptr<TObject> obj(key->ReadObj());
+        if (obj->InheritsFrom("TH1")) {
+            TH1* hist = (TH1*)obj.get();
+            if (first) {
+                hist->SetDirectory(nullptr);
+                item.hist.reset((TH1*)obj.release());
+            } else if (!item.hist || !item.hist->Add(hist)) {
+                std::cerr << "ERROR: cannot add " << where << "\n";
+                return false;
+            }
+        } else if (obj->InheritsFrom("TTree")) {
+            if (first) item.tree.reset(new MergedTree);
+            if (!item.tree || !MergeTree((TTree*)obj.get(), where, *item.tree, first)) return false;
+        } else if (className == "TParameter<Long64_t>") {
+            item.sum += ((TParameter<Long64_t>*)obj.get())->GetVal();
+        } else if (first) {
+            item.fixed = std::move(obj);
+        } else if (!item.fixed || std::string(item.fixed->GetTitle()) != obj->GetTitle()) {
+            std::cerr << "ERROR: " << where << " differs from the first file\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+
+// Writes a merged tree into the current directory
+inline void WriteMergedTree(const std::string& name, const MergedTree& merged) {
+    TTree* tree = new TTree(name.c_str(), merged.title.c_str());
+    std::vector<std::vector<char>> buffers;
+    for (const MergedTree::Column& column : merged.columns) {
+        size_t size = column.type == 'F' || column.type == 'I' ? 4 : 8;
+        buffers.emplace_back(size * column.len);
+        tree->Branch(column.name.c_str(), buffers.back().data(), column.leaflist.c_str());
+    }
+    for (Long64_t entry = 0; entry < merged.entries; ++entry) {
+        for (size_t i = 0; i < merged.columns.size(); ++i) {
+            const MergedTree::Column& column = merged.columns[i];
+            char* buffer = buffers[i].data();
+            for (int j = 0; j < column.len; ++j) {
+                double value = column.values[entry * column.len + j];
+                switch (column.type) {
+                    case 'F': ((float*)buffer)[j]    = value; break;
+                    case 'D': ((double*)buffer)[j]   = value; break;
+                    case 'I': ((int*)buffer)[j]      = value; break;
+                    case 'L': ((Long64_t*)buffer)[j] = value; break;
+                }
+            }
+        }
+        tree->Fill();
+    }
+    tree->Write();
+    delete tree;
+}
+
+inline void WriteMergedDirectory(const MergedDir& merged, TDirectory* out) {
+    for (const std::string& name : merged.order) {
+        const MergedDir::Item& item = merged.items.at(name);
+        out->cd();
+        if (item.dir)        WriteMergedDirectory(*item.dir, out->mkdir(name.c_str()));
+        else if (item.hist)  out->WriteTObject(item.hist.get());
+        else if (item.tree)  WriteMergedTree(name, *item.tree);
+        else if (item.fixed) out->WriteTObject(item.fixed.get());
+        else {
+            TParameter<Long64_t> sum(name.c_str(), item.sum);
+            out->WriteTObject(&sum);
+        }
+    }
+}
+
+
+// Merges `files` into `output`. range: event_range/ of the output (from
+// CheckEventRanges), none for a partial merge.
+inline bool MergeFiles(const std::vector<std::string>& files, const std::string& output,
+                       const EventRangeSettings* range = nullptr) {
+
+    bool addDirectory = TH1::AddDirectoryStatus();
+    TH1::AddDirectory(false);
+
+    MergedDir merged;
+    bool ok = true;
+    for (size_t i = 0; i < files.size() && ok; ++i) {
+        std::unique_ptr<TFile> in(TFile::Open(files[i].c_str()));
+        if (!in || in->IsZombie()) {
+            std::cerr << "ERROR: cannot open " << files[i] << "\n";
+            ok = false;
+            break;
+        }
+        ok = MergeDirectory(in.get(), files[i], merged, i == 0);
+        in->Close();
+    }
+
+    if (ok) {
+        TFile out(output.c_str(), "RECREATE");
+        if (out.IsZombie()) {
+            std::cerr << "ERROR: cannot create " << output << "\n";
+            ok = false;
+        } else {
+            WriteMergedDirectory(merged, &out);
+            if (range) WriteEventRange(&out, *range);
+            out.Close();
+        }
+    }
+
+    TH1::AddDirectory(addDirectory);
+    return ok;
+}
+
+#endif
@@ -0,0 +1,190 @@
+// Skim of the 1gX preselected events (--skim <file.root>).
+//
+// The skim keeps only the events that pass the preselection of at least one
+// variant (with --bdt-scan also those passing the score independent cuts),
+// and only the branches of the branch manifest, merged from the five input
+// trees into a single tree (branch names are unique across the trees and are
+// kept as they are). T_pot is copied as well. The skim can be given back to
+// anamacro_1gX_blips_signal as <input_file>: the five set_vars setBranches*()
+// functions then all bind to the skim tree.
+//
+// The cut sets the skim was made with are written into it (skim_selection).
+// A re-run on the skim with another cut set, or with --bdt-scan if the skim
+// was made without, would silently miss events: it is refused.
+
+#ifndef SKIM_H
+#define SKIM_H
+
+#include <TBranchElement.h>
+#include <TChain.h>
+#include <TFile.h>
+#include <TLeaf.h>
+#include <TNamed.h>
+#include <TObjArray.h>
+#include <TParameter.h>
+#include <TTree.h>
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "branch_manifest.h"
+#include "selection_variants.h"
+
+
+const char* const kSkimTree = "skim_1gX";
+const char* const kPOTTree  = "wcpselection/T_pot";
+
+// Number of input entries the skim was made from (the denominator of the
+// "signal events/total events" print-out)
+const char* const kSkimSourceEntries = "skim_source_entries";
+
+// The cut sets of the skim, one "cuts=" line each (DescribeCuts), and
+// "bdt_scan=1" if it has the --bdt-scan events
+const char* const kSkimSelection = "skim_selection";
+
+
+inline bool IsSkimFile(const std::string& file) {
+    TFile* f = TFile::Open(file.c_str());
+    bool isSkim = f && !f->IsZombie() && f->Get(kSkimTree);
+    if (f) f->Close();
+    return isSkim;
+}
+
+
+// Every manifest branch, in manifest order (also the RDataFrame snapshot columns)
+inline std::vector<std::string> SkimBranches() {
+    std::vector<std::string> branches;
+    for (const char* path : {kPeLEETree, kPFevalTree, kKINETree, kBDTTree, kEvalTree})
+        for (const std::string& name : ManifestBranches(path)) branches.push_back(name);
+    return branches;
+}
+
+
+inline const char* LeafTypeCode(const std::string& typeName) {
+    if (typeName == "Float_t")   return "F";
+    if (typeName == "Double_t")  return "D";
+    if (typeName == "Int_t")     return "I";
+    if (typeName == "UInt_t")    return "i";
+    if (typeName == "Short_t")   return "S";
+    if (typeName == "UShort_t")  return "s";
+    if (typeName == "Char_t")    return "B";
+    if (typeName == "UChar_t")   return "b";
+    if (typeName == "Bool_t")    return "O";
+    if (typeName == "Long64_t")  return "L";
+    if (typeName == "ULong64_t") return "l";
+    return nullptr;
+}
+
+
+// Creates the skim tree in the current directory. Each branch is bound to the
+// same set_vars variable as the input branch it copies, so Fill() after the
+// payload of an event has been read writes that event.
+inline TTree* CreateSkimTree(const std::vector<InputTree>& inputs) {
+
+    TTree* skim = new TTree(kSkimTree, "1gX preselected events");
+
+    for (const InputTree& in : inputs) {
+        for (const std::string& name : ManifestBranches(in.path)) {
+            TBranch* branch = in.tree->GetBranch(name.c_str());
+            if (!branch || !branch->GetAddress()) {
+                std::cerr << "WARNING: skim: branch '" << name << "' of " << in.path << " is not bound, not copied\n";
+                continue;
+            }
+
+            if (branch->InheritsFrom("TBranchElement")) {   // std::vector<...>* branches
+                skim->Branch(name.c_str(), ((TBranchElement*)branch)->GetClassName(), (void*)branch->GetAddress());
+                continue;
+            }
+
+            // Leaf branches: scalars and (variable size) arrays, the leaf title
+            // keeps the dimension, e.g. kine_energy_particle[kine_nparticles]
+            TLeaf* leaf = (TLeaf*)branch->GetListOfLeaves()->At(0);
+            const char* code = LeafTypeCode(leaf->GetTypeName());
+            if (!code) {
+                std::cerr << "WARNING: skim: branch '" << name << "' has unsupported type "
+                          << leaf->GetTypeName() << ", not copied\n";
+                continue;
+            }
+            skim->Branch(name.c_str(), (void*)branch->GetAddress(), (std::string(leaf->GetTitle()) + "/" + code).c_str());
+        }
+    }
+    return skim;
+}
+
+
+// Creates the skim file with a copy of T_pot. The skim tree itself is added
+// later by the engine that fills it.
+inline bool CreateSkimFile(const std::string& skimFile, TTree* pot) {
+
+    TFile out(skimFile.c_str(), "RECREATE");
+    if (out.IsZombie()) {
+        std::cerr << "ERROR: Could not create skim file " << skimFile << "\n";
+        return false;
+    }
+    out.mkdir("wcpselection")->cd();
+    TTree* potCopy = pot->CloneTree(-1, "fast");
+    potCopy->Write();
+    out.Close();
+    return true;
+}
+
+
+// Records how many input entries the skim was made from
+inline void WriteSkimSourceEntries(TDirectory* dir, Long64_t nevents) {
+    TParameter<Long64_t> entries(kSkimSourceEntries, nevents);
+    dir->WriteTObject(&entries);
+}
+
+inline Long64_t ReadSkimSourceEntries(const std::vector<std::string>& files) {
+    Long64_t nevents = 0;
+    for (const std::string& file : files) {
+        TFile* f = TFile::Open(file.c_str());
+        TParameter<Long64_t>* entries = nullptr;
+        if (f && !f->IsZombie()) f->GetObject(kSkimSourceEntries, entries);
+        if (entries) nevents += entries->GetVal();
+        if (f) f->Close();
+    }
+    return nevents;
+}
+
+
+inline void WriteSkimSelection(TDirectory* dir, const std::vector<SelectionCuts>& cutSets, bool bdtScan) {
+    std::string selection;
+    for (const SelectionCuts& cuts : cutSets) selection += "cuts=" + DescribeCuts(cuts) + "\n";
+    if (bdtScan) selection += "bdt_scan=1\n";
+    TNamed record(kSkimSelection, selection.c_str());
+    dir->WriteTObject(&record);
+}
+
+// False (with an ERROR) if a file of the skim was not made with every cut
+// set of cutSets, or without the --bdt-scan events when bdtScan
+inline bool CheckSkimSelection(const std::vector<std::string>& files, const std::vector<SelectionCuts>& cutSets,
+                               bool bdtScan) {
+    for (const std::string& file : files) {
+        TFile* f = TFile::Open(file.c_str());
+        TNamed* record = nullptr;
+        if (f && !f->IsZombie()) f->GetObject(kSkimSelection, record);
+        std::string selection = record ? record->GetTitle() : "";
+        if (f) f->Close();
+        if (!record) {
+            std::cerr << "ERROR: skim " << file << " does not record the cuts it was made with (" << kSkimSelection
+                      << "); make it again\n";
+            return false;
+        }
+        for (const SelectionCuts& cuts : cutSets) {
+            if (selection.find("cuts=" + DescribeCuts(cuts) + "\n") != std::string::npos) continue;
+            std::cerr << "ERROR: skim " << file << " was not made with the " << cuts.name
+                      << " cuts, it would miss events. It has:\n" << selection;
+            return false;
+        }
+        if (bdtScan && selection.find("bdt_scan=1\n") == std::string::npos) {
+            std::cerr << "ERROR: skim " << file << " was made without --bdt-scan and does not have all the events "
+                      << "the scan needs\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+#endif
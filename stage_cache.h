@@ -0,0 +1,213 @@
+// Local staging cache of the input files (--stage-dir, --stage-limit).
+//
+// The run_anamacro_*.sh scripts read the same reco2 files from dCache for
+// every job. With --stage-dir DIR each input file is first hard-linked (same
+// file system) or copied (TFile::Cp, so xrootd URLs work too) into DIR, under
+// a name made of a hash of its path, size and modification time plus its base
+// name, and the job reads that copy. The next job on the same file finds it
+// there. A changed source file gets a new name, so a stale copy is never used.
+//
+// Each staged file has two lock files next to it. A job holds the .fetch
+// lock while it looks the file up and fetches it, so concurrent jobs on the
+// node wait for the first one instead of fetching the file twice. It holds a
+// shared lock on the .lock file from the lookup to its exit (the forked
+// workers inherit it), and a file is only evicted under an exclusive lock on
+// it, so the files in use by any job stay. The .lock file's mtime is the last
+// use of the file. Before a fetch, the least recently used files are deleted
+// until the new one fits in --stage-limit. Hits, misses and evictions are
+// printed and appended to DIR/stage.log.
+
+#ifndef STAGE_CACHE_H
+#define STAGE_CACHE_H
+
+#include <TFile.h>
+#include <TString.h>
+#include <TSystem.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <fcntl.h>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utime.h>
+#include <vector>
+
+
+const double kDefaultStageLimitGB = 100;
+
+
+struct StageSettings {
+    std::string dir;                                       // empty: no staging
+    Long64_t    limitBytes = (Long64_t)(kDefaultStageLimitGB * 1024 * 1024 * 1024);
+    int         hits = 0, misses = 0, skipped = 0;
+    std::vector<int> inUse;                                // shared locks on the files of this job, held until exit
+
+    bool enabled() const { return !dir.empty(); }
+};
+
+inline StageSettings gStage;
+
+
+inline bool ParseStageLimit(const std::string& value, Long64_t& bytes) {
+    char* end = nullptr;
+    double gb = std::strtod(value.c_str(), &end);
+    if (value.empty() || *end != '\0' || !(gb > 0)) {
+        std::cerr << "ERROR: --stage-limit takes a size in GB, got '" << value << "'\n";
+        return false;
+    }
+    bytes = (Long64_t)(gb * 1024 * 1024 * 1024);
+    return true;
+}
+
+
+// flock() on a lock file (exclusive unless shared), released when it goes
+// out of scope unless Keep() hands the descriptor over
+class StageLock {
+public:
+    StageLock(const std::string& path, bool wait = true, bool shared = false) {
+        fFd = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+        if (fFd >= 0 && flock(fFd, (shared ? LOCK_SH : LOCK_EX) | (wait ? 0 : LOCK_NB)) != 0) {
+            close(fFd);
+            fFd = -1;
+        }
+    }
+    ~StageLock() {
+        if (fFd >= 0) close(fFd);   // releases the lock
+    }
+    explicit operator bool() const { return fFd >= 0; }
+    int Keep() {
+        int fd = fFd;
+        fFd = -1;
+        return fd;
+    }
+private:
+    int fFd;
+};
+
+
+// FNV-1a of path, size and mtime
+inline uint64_t StageKey(const std::string& path, Long64_t size, Long_t mtime) {
+    std::string key = path + "|" + std::to_string(size) + "|" + std::to_string(mtime);
+    uint64_t h = 0xcbf29ce484222325ULL;
+    for (unsigned char c : key) h = (h ^ c) * 0x100000001b3ULL;
+    return h;
+}
+
+inline void LogStage(const std::string& message) {
+    std::cout << "Staging: " << message << std::endl;
+    std::ofstream log(gStage.dir + "/stage.log", std::ios::app);
+    char date[32];
+    std::time_t now = std::time(nullptr);
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+    log << date << " " << gSystem->HostName() << ":" << getpid() << " " << message << "\n";
+}
+
+
+// Deletes the least recently used staged files until `needed` more bytes fit
+// in the limit. Files in use by a job (shared lock held) and `keep` are left
+// alone. Call with the directory lock held.
+inline void EvictStaged(Long64_t needed, const std::string& keep) {
+    struct Staged { std::string path; Long64_t size; time_t lastUse; };
+    std::vector<Staged> staged;
+    Long64_t total = 0;
+    void* handle = gSystem->OpenDirectory(gStage.dir.c_str());
+    if (!handle) return;
+    while (const char* entry = gSystem->GetDirEntry(handle)) {
+        std::string name = entry;
+        if (name.size() < 6 || name.compare(name.size() - 5, 5, ".root") != 0) continue;   // not lock, log or .part
+        std::string path = gStage.dir + "/" + name;
+        struct stat st, lock;
+        if (stat(path.c_str(), &st) != 0) continue;
+        time_t lastUse = stat((path + ".lock").c_str(), &lock) == 0 ? lock.st_mtime : st.st_mtime;
+        staged.push_back({path, (Long64_t)st.st_size, lastUse});
+        total += st.st_size;
+    }
+    gSystem->FreeDirectory(handle);
+
+    std::sort(staged.begin(), staged.end(), [](const Staged& a, const Staged& b) { return a.lastUse < b.lastUse; });
+    for (const Staged& file : staged) {
+        if (total + needed <= gStage.limitBytes) break;
+        if (file.path == keep) continue;
+        StageLock lock(file.path + ".lock", false);
+        if (!lock) continue;   // in use
+        if (unlink(file.path.c_str()) != 0) continue;
+        total -= file.size;
+        LogStage(Form("evicted %s (%.1f MB)", file.path.c_str(), file.size / 1048576.));
+    }
+}
+
+
+// Local copy of `source`, or source itself if it cannot be staged
+inline std::string StageFile(const std::string& source) {
+
+    FileStat_t st;
+    if (gSystem->GetPathInfo(source.c_str(), st) != 0) {
+        LogStage("skipped " + source + " (cannot stat it)");
+        gStage.skipped++;
+        return source;
+    }
+    if (st.fSize > gStage.limitBytes) {
+        LogStage(Form("skipped %s (%.1f MB, larger than --stage-limit)", source.c_str(), st.fSize / 1048576.));
+        gStage.skipped++;
+        return source;
+    }
+
+    std::string local = Form("%s/%016llx_%s", gStage.dir.c_str(), (unsigned long long)StageKey(source, st.fSize, st.fMtime),
+                             gSystem->BaseName(source.c_str()));
+    std::string lockPath = local + ".lock";
+    StageLock fetchLock(local + ".fetch");   // waits while another job fetches this file
+    StageLock useLock(lockPath, true, true);  // waits while another job evicts it
+    if (!fetchLock || !useLock) {
+        std::cerr << "WARNING: cannot lock " << local << ", reading " << source << " directly\n";
+        gStage.skipped++;
+        return source;
+    }
+
+    struct stat cached;
+    if (stat(local.c_str(), &cached) == 0 && (Long64_t)cached.st_size == st.fSize) {
+        utime(lockPath.c_str(), nullptr);
+        LogStage("hit " + source + " -> " + local);
+        gStage.hits++;
+        gStage.inUse.push_back(useLock.Keep());
+        return local;
+    }
+
+    {
+        StageLock dirLock(gStage.dir + "/.stage.lock");
+        EvictStaged(st.fSize, local);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::string part = local + Form(".%d.part", getpid());
+    bool linked = link(source.c_str(), part.c_str()) == 0;
+    if ((!linked && !TFile::Cp(source.c_str(), part.c_str(), false)) || rename(part.c_str(), local.c_str()) != 0) {
+        unlink(part.c_str());
+        std::cerr << "WARNING: could not stage " << source << ", reading it directly\n";
+        gStage.skipped++;
+        return source;
+    }
+    utime(lockPath.c_str(), nullptr);
+    gStage.inUse.push_back(useLock.Keep());
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    LogStage(Form("miss %s -> %s (%s, %.1f MB in %.1f s)", source.c_str(), local.c_str(),
+                  linked ? "hard link" : "copied", st.fSize / 1048576., seconds));
+    gStage.misses++;
+    return local;
+}
+
+inline std::vector<std::string> StageInputFiles(const std::vector<std::string>& files) {
+    if (gSystem->AccessPathName(gStage.dir.c_str())) gSystem->mkdir(gStage.dir.c_str(), true);
+    std::vector<std::string> staged;
+    for (const std::string& file : files) staged.push_back(StageFile(file));
+    std::cout << "Staging: " << gStage.hits << " hits, " << gStage.misses << " misses, " << gStage.skipped
+              << " read directly (" << gStage.dir << ")" << std::endl;
+    return staged;
+}
+
+#endif
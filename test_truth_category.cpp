@@ -0,0 +1,166 @@
+// Unit test of truth_category.h, without ROOT or input files.
+//
+// Every branch of the old else-if chain of the truth breakdown is given a
+// hand-made TruthInputs and checked against the category it must give,
+// including the NaN match (neither signal nor background), and the 0n/Nn and
+// 0p/Np split bits are checked on both sides of their boundaries.
+//
+// g++ -std=c++17 test_truth_category.cpp -o test_truth_category && ./test_truth_category
+
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <string>
+
+#include "truth_category.h"
+
+
+int gFailures = 0;
+
+void Check(bool ok, const std::string& what) {
+    if (ok) return;
+    std::cerr << "FAILED: " << what << "\n";
+    gFailures++;
+}
+
+const char* CategoryName(SPCategory c) {
+    return c == kNoSPCategory ? "none" : kSPCategoryNames[c];
+}
+
+void CheckCategory(const TruthInputs& t, SPCategory expected, const std::string& what) {
+    SPCategory got = ClassifyTruth(t);
+    Check(got == expected, what + ": got " + CategoryName(got) + ", expected " + CategoryName(expected));
+}
+
+
+// Well matched NC event with its vertex in the FV, no photon, no pi0
+TruthInputs BaseEvent() {
+    TruthInputs t;
+    t.match_completeness_energy = 1.0;
+    t.truth_energyInside        = 1.0;
+    t.truth_single_photon       = 0;
+    t.truth_isCC                = 0;
+    t.truth_NCDelta             = 0;
+    t.truth_vtxInside           = 1;
+    t.truth_showerMother        = 22;
+    t.truth_nuPdg               = 14;
+    t.truth_muonEnergy          = 0;
+    t.truth_Npi0                = 0;
+    return t;
+}
+
+TruthInputs SinglePhoton() {
+    TruthInputs t = BaseEvent();
+    t.truth_single_photon = 1;
+    return t;
+}
+
+// numu CC with a muon below 100 MeV kinetic energy
+TruthInputs NumuCC0pi(int vtxInside) {
+    TruthInputs t = SinglePhoton();
+    t.truth_isCC = 1;
+    t.truth_nuPdg = -14;
+    t.truth_muonEnergy = 0.15;
+    t.truth_vtxInside = vtxInside;
+    return t;
+}
+
+
+void TestMatch() {
+    TruthInputs t = SinglePhoton();
+    t.match_completeness_energy = 0.05;
+    CheckCategory(t, kCosmicBkg, "completeness below 10% of the energy inside");
+
+    t.match_completeness_energy = 1.0;
+    t.truth_energyInside = 10.0;
+    CheckCategory(t, kCosmicBkg, "completeness at 10% of the energy inside");
+
+    t.match_completeness_energy = std::numeric_limits<float>::quiet_NaN();
+    CheckCategory(t, kNoSPCategory, "NaN completeness");
+
+    t = SinglePhoton();
+    t.truth_energyInside = std::numeric_limits<float>::quiet_NaN();
+    CheckCategory(t, kNoSPCategory, "NaN energy inside");
+}
+
+void TestSignal() {
+    TruthInputs t = SinglePhoton();
+    t.truth_NCDelta = 1;
+    CheckCategory(t, kSPNCDeltaSig, "NC Delta in FV");
+
+    t = SinglePhoton();
+    t.truth_showerMother = 111;
+    CheckCategory(t, kSPNCPi0Sig, "NC pi0 photon in FV");
+
+    t = SinglePhoton();
+    CheckCategory(t, kSPNCOtherSig, "NC other photon in FV");
+
+    CheckCategory(NumuCC0pi(1), kSPNumuCCSig, "numu CC 0pi in FV");
+
+    t = SinglePhoton();
+    t.truth_NCDelta = 1;
+    t.truth_vtxInside = 0;
+    CheckCategory(t, kSPOutFVSig, "NC out of FV");
+    CheckCategory(NumuCC0pi(0), kSPOutFVSig, "numu CC 0pi out of FV");
+
+    t = SinglePhoton();
+    t.truth_NCDelta = 2;   // none of the NC branches in FV
+    CheckCategory(t, kSPNumuCCSigGen, "NC single photon in no other signal category");
+
+    // Not a signal category: falls through to the backgrounds
+    t = NumuCC0pi(1);
+    t.truth_muonEnergy = 0.5;
+    CheckCategory(t, kSPnumuCCBkg, "single photon numu CC with an energetic muon");
+}
+
+void TestBackground() {
+    TruthInputs t = BaseEvent();
+    t.truth_vtxInside = 0;
+    CheckCategory(t, kSPoutFVBkg, "out of FV");
+
+    t = BaseEvent();
+    t.truth_isCC = 1;
+    CheckCategory(t, kSPnumuCCBkg, "numu CC without pi0");
+    t.truth_Npi0 = 2;
+    CheckCategory(t, kSPnumuCCpi0Bkg, "numu CC with pi0");
+
+    t = BaseEvent();
+    t.truth_isCC = 1;
+    t.truth_nuPdg = -12;
+    CheckCategory(t, kSPnueCCBkg, "nue CC");
+
+    t = BaseEvent();
+    CheckCategory(t, kSPNCBkg, "NC without pi0");
+    t.truth_Npi0 = 1;
+    CheckCategory(t, kSPNCpi0Bkg, "NC with pi0");
+
+    t = BaseEvent();
+    t.truth_isCC = 1;
+    t.truth_nuPdg = 16;
+    CheckCategory(t, kNoSPCategory, "nutau CC");
+}
+
+void TestSplits() {
+    Check(Is0n(9, 8), "9 blips, 8 MeV is 0n");
+    Check(!Is0n(10, 1), "10 blips is Nn");
+    Check(!Is0n(1, 8.5), "8.5 MeV is Nn");
+
+    Check(EventSplitBits(0, 0, true) == (kIs0n | kIs0p), "0n 0p");
+    Check(EventSplitBits(0, 0, false) == kIs0n, "0n Np");
+    Check(EventSplitBits(20, 50, true) == kIs0p, "Nn 0p");
+    Check(EventSplitBits(20, 50, false) == 0, "Nn Np");
+}
+
+
+int main() {
+    TestMatch();
+    TestSignal();
+    TestBackground();
+    TestSplits();
+    if (gFailures) {
+        std::cerr << gFailures << " checks failed\n";
+        return 1;
+    }
+    std::cout << "truth_category.h: all checks passed\n";
+    return 0;
+}
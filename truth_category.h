@@ -0,0 +1,92 @@
+// Truth category and 0n/Nn, 0p/Np split of a selected event.
+//
+// The single photon breakdown used to be an else-if chain over the truth
+// variables, written out once for each of the all/0n/Nn histogram sets. Here
+// the chain is evaluated once per event into an SPCategory, and the event
+// splits into a bitmask, and every fill site indexes with those. Both
+// functions only depend on their arguments, so they can be checked on their
+// own with hand-made inputs.
+
+#ifndef TRUTH_CATEGORY_H
+#define TRUTH_CATEGORY_H
+
+#include <cstdlib>
+
+
+// Single photon breakdown categories, in the order they are tested.
+// The histograms are "h_" + name + "_Nprotons" + split suffix.
+enum SPCategory {
+    kNoSPCategory = -1,   // neither signal nor background (counted in NoSigNorBkg)
+    kSPNCDeltaSig = 0, kSPNCPi0Sig, kSPNCOtherSig, kSPNumuCCSig, kSPOutFVSig, kSPNumuCCSigGen,
+    kSPoutFVBkg, kSPnumuCCBkg, kSPnumuCCpi0Bkg, kSPnueCCBkg, kSPNCBkg, kSPNCpi0Bkg, kCosmicBkg,
+    kNSPCategories
+};
+
+const int kNSPSignalCategories = kSPoutFVBkg;   // the signal categories come first
+
+const char* const kSPCategoryNames[kNSPCategories] = {
+    "SPNCDeltaSig", "SPNCPi0Sig", "SPNCOtherSig", "SPNumuCCSig", "SPOutFVSig", "SPNumuCCSigGen",
+    "SPoutFVBkg", "SPnumuCCBkg", "SPnumuCCpi0Bkg", "SPnueCCBkg", "SPNCBkg", "SPNCpi0Bkg", "CosmicBkg"
+};
+
+
+// Truth variables the categories look at, copied out of the branch variables
+// (or RDataFrame columns) once per event
+struct TruthInputs {
+    float match_completeness_energy;
+    float truth_energyInside;
+    int   truth_single_photon;
+    int   truth_isCC;
+    int   truth_NCDelta;
+    int   truth_vtxInside;
+    int   truth_showerMother;
+    int   truth_nuPdg;
+    float truth_muonEnergy;   // truth_muonMomentum[3]
+    int   truth_Npi0;
+};
+
+
+inline SPCategory ClassifyTruth(const TruthInputs& t) {
+
+    if (!(t.match_completeness_energy > 0.1 * t.truth_energyInside))   // bad match (neither if NaN)
+        return t.match_completeness_energy <= 0.1 * t.truth_energyInside ? kCosmicBkg : kNoSPCategory;
+
+    bool numuCC0pi = t.truth_isCC == 1 && std::abs(t.truth_nuPdg) == 14 && t.truth_muonEnergy - 0.105658 < 0.1;
+
+    // Signal categories
+    if (t.truth_single_photon == 1) {
+        if (t.truth_isCC == 0 && t.truth_NCDelta == 1 && t.truth_vtxInside == 1)                              return kSPNCDeltaSig;
+        if (t.truth_isCC == 0 && t.truth_showerMother == 111 && t.truth_vtxInside == 1)                       return kSPNCPi0Sig;
+        if (t.truth_isCC == 0 && t.truth_showerMother != 111 && t.truth_NCDelta == 0 && t.truth_vtxInside == 1) return kSPNCOtherSig;
+        if (numuCC0pi && t.truth_vtxInside == 1)                                                              return kSPNumuCCSig;
+        if ((t.truth_isCC == 0 || numuCC0pi) && t.truth_vtxInside == 0)                                       return kSPOutFVSig;
+        if (t.truth_isCC == 0)                                                                                return kSPNumuCCSigGen;
+    }
+
+    // Background categories
+    if (t.truth_vtxInside == 0)                                                                         return kSPoutFVBkg;
+    if (std::abs(t.truth_nuPdg) == 14 && t.truth_isCC == 1 && t.truth_vtxInside == 1 && t.truth_Npi0 == 0) return kSPnumuCCBkg;
+    if (std::abs(t.truth_nuPdg) == 14 && t.truth_isCC == 1 && t.truth_vtxInside == 1 && t.truth_Npi0 > 0)  return kSPnumuCCpi0Bkg;
+    if (std::abs(t.truth_nuPdg) == 12 && t.truth_isCC == 1 && t.truth_vtxInside == 1)                      return kSPnueCCBkg;
+    if (t.truth_isCC == 0 && t.truth_vtxInside == 1 && t.truth_Npi0 == 0)                                  return kSPNCBkg;
+    if (t.truth_isCC == 0 && t.truth_vtxInside == 1 && t.truth_Npi0 > 0)                                   return kSPNCpi0Bkg;
+    return kNoSPCategory;
+}
+
+
+// Event split bits: 0n (few, soft signal blips) or Nn, and 0p (no WC proton)
+// or Np
+enum EventSplitBit {
+    kIs0n = 1 << 0,
+    kIs0p = 1 << 1
+};
+
+inline bool Is0n(int n_sig_all_blips, float SumE_sig_all_blips) {
+    return n_sig_all_blips < 10 && SumE_sig_all_blips <= 8;
+}
+
+inline int EventSplitBits(int n_sig_all_blips, float SumE_sig_all_blips, bool is0p) {
+    return (Is0n(n_sig_all_blips, SumE_sig_all_blips) ? kIs0n : 0) | (is0p ? kIs0p : 0);
+}
+
+#endif